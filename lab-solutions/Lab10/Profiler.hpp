@@ -0,0 +1,335 @@
+/**************************************************************************************************
+    Profiler:
+        Builds on the Stopwatch from Task 1 to attribute the time of a code region to compute
+        versus memory stalls. A ProfileScope measures the region it lives in and, depending on
+        the requested counters, also captures:
+
+            - CPU cycles from the time-stamp counter (rdtsc on x86, unavailable elsewhere)
+            - retired instructions, CPU cycles and last-level cache misses for the calling
+              thread through perf_event_open (Linux only; unavailable if the kernel forbids it)
+            - bytes allocated during the region through Lab7's MemoryTracker. Define
+              PROFILE_ALLOCATIONS before including this header in exactly one translation unit,
+              since MemoryTracker replaces the global operator new; that unit installs the hook
+              through which every other unit reads the count.
+
+        Finished scopes (and their laps) are aggregated by name in a thread-safe ProfileRegistry:
+
+            {
+                ProfileScope scope("shell_sort", Counters::All);
+                shell_sort(arr);
+            }
+            ProfileRegistry::global().report(std::cout);
+**************************************************************************************************/
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+#include "Stopwatch.hpp"
+
+#if defined(PROFILE_ALLOCATIONS)
+#include "../Lab7/MemoryTracker.hpp"
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_HAS_RDTSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define PROFILER_HAS_RDTSC 1
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+// Bit flags selecting what a ProfileScope captures in addition to wall time
+struct Counters {
+    enum : unsigned {
+        Time = 0,
+        Cycles = 1 << 0,        // Time-stamp counter
+        Hardware = 1 << 1,      // Instructions, cycles and cache misses (perf_event_open)
+        Allocations = 1 << 2,   // Bytes allocated (MemoryTracker)
+        All = Cycles | Hardware | Allocations
+    };
+};
+
+struct ProfileSample {
+    double seconds = 0.0;
+    std::uint64_t tsc_cycles = 0;
+    std::uint64_t cpu_cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t cache_misses = 0;
+    std::uint64_t bytes_allocated = 0;
+};
+
+inline std::uint64_t read_tsc() {
+#if defined(PROFILER_HAS_RDTSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Set during static initialization by the translation unit that defines PROFILE_ALLOCATIONS, so
+// allocated_bytes has one definition everywhere; it stays null (and reads 0) without one
+inline std::uint64_t(*allocation_counter)() = nullptr;
+
+inline std::uint64_t allocated_bytes() { return allocation_counter ? allocation_counter() : 0; }
+
+#if defined(PROFILE_ALLOCATIONS)
+static const bool allocation_counter_installed = (allocation_counter = []() -> std::uint64_t {
+    return MemoryTracker::allocatedMemory.load(std::memory_order_relaxed);
+    }, true);
+#endif
+
+/**
+ * @brief Per-thread hardware event counters (instructions, cycles, cache misses).
+ *
+ * Opened with perf_event_open for the calling thread on any CPU, enabled from the start and
+ * never reset, so any number of nested or overlapping scopes can share them: each reads the
+ * counters when it starts and subtracts that from the values when it stops. If the events
+ * cannot be opened (non-Linux, containers, perf_event_paranoid) available() is false and all
+ * reads return zero.
+ *
+ * When more events are open than the CPU has counters, the kernel multiplexes them and each
+ * event only counts for part of the time. Every read therefore also returns how long the event
+ * was enabled and how long it was actually counting, and a count is scaled up by their ratio
+ * over the interval, as perf stat does.
+ */
+class HardwareCounters {
+    static constexpr int event_count = 3;
+    int fds[event_count] = { -1, -1, -1 };
+
+#if defined(__linux__)
+    static int open_event(std::uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+public:
+    // Raw counts with the nanoseconds each event was enabled and actually counting
+    struct Reading {
+        std::uint64_t value[event_count] = {};
+        std::uint64_t enabled[event_count] = {};
+        std::uint64_t running[event_count] = {};
+    };
+
+private:
+    void read_event(int index, Reading& reading) const {
+#if defined(__linux__)
+        std::uint64_t values[3]; // In the order of read_format: value, time enabled, time running
+        if (fds[index] >= 0 && ::read(fds[index], values, sizeof(values)) == sizeof(values)) {
+            reading.value[index] = values[0];
+            reading.enabled[index] = values[1];
+            reading.running[index] = values[2];
+        }
+#else
+        (void)index;
+        (void)reading;
+#endif
+    }
+
+    // The count of one event between two readings, scaled for the time it was multiplexed out
+    static std::uint64_t scaled(const Reading& start, const Reading& end, int index) {
+        const std::uint64_t value = end.value[index] - start.value[index];
+        const std::uint64_t enabled = end.enabled[index] - start.enabled[index];
+        const std::uint64_t running = end.running[index] - start.running[index];
+        if (running == 0) return 0;
+        if (running >= enabled) return value;
+        return static_cast<std::uint64_t>(static_cast<double>(value) * enabled / running);
+    }
+
+public:
+    HardwareCounters() {
+#if defined(__linux__)
+        fds[0] = open_event(PERF_COUNT_HW_INSTRUCTIONS);
+        fds[1] = open_event(PERF_COUNT_HW_CPU_CYCLES);
+        fds[2] = open_event(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+
+    ~HardwareCounters() {
+#if defined(__linux__)
+        for (int fd : fds) if (fd >= 0) close(fd);
+#endif
+    }
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    bool available() const { return fds[0] >= 0; }
+
+    // The current counts of the calling thread
+    Reading read() const {
+        Reading reading;
+        for (int index = 0; index < event_count; ++index) read_event(index, reading);
+        return reading;
+    }
+
+    // Writes the counts from start to end into sample
+    static void difference(const Reading& start, const Reading& end, ProfileSample& sample) {
+        sample.instructions = scaled(start, end, 0);
+        sample.cpu_cycles = scaled(start, end, 1);
+        sample.cache_misses = scaled(start, end, 2);
+    }
+};
+
+/**
+ * @brief Thread-safe aggregation of profile samples by name.
+ */
+class ProfileRegistry {
+public:
+    struct Entry {
+        std::uint64_t count = 0;
+        double total_seconds = 0.0;
+        double min_seconds = std::numeric_limits<double>::max();
+        double max_seconds = 0.0;
+        ProfileSample totals;
+
+        double average_seconds() const { return count ? total_seconds / count : 0.0; }
+        double instructions_per_cycle() const {
+            return totals.cpu_cycles ? static_cast<double>(totals.instructions) / totals.cpu_cycles : 0.0;
+        }
+    };
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, Entry> entries;
+
+public:
+    static ProfileRegistry& global() {
+        static ProfileRegistry registry;
+        return registry;
+    }
+
+    void record(const std::string& name, const ProfileSample& sample) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry& entry = entries[name];
+        ++entry.count;
+        entry.total_seconds += sample.seconds;
+        entry.min_seconds = std::min(entry.min_seconds, sample.seconds);
+        entry.max_seconds = std::max(entry.max_seconds, sample.seconds);
+        entry.totals.seconds += sample.seconds;
+        entry.totals.tsc_cycles += sample.tsc_cycles;
+        entry.totals.cpu_cycles += sample.cpu_cycles;
+        entry.totals.instructions += sample.instructions;
+        entry.totals.cache_misses += sample.cache_misses;
+        entry.totals.bytes_allocated += sample.bytes_allocated;
+    }
+
+    // Copy of the current entries, safe to inspect while other threads keep recording
+    std::map<std::string, Entry> snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }
+
+    void report(std::ostream& os) const {
+        std::map<std::string, Entry> copy = snapshot();
+        os << std::left << std::setw(28) << "Name" << std::right
+            << std::setw(8) << "Count" << std::setw(14) << "Avg (ms)" << std::setw(14) << "Min (ms)"
+            << std::setw(14) << "Max (ms)" << std::setw(16) << "TSC cycles" << std::setw(16) << "Instructions"
+            << std::setw(8) << "IPC" << std::setw(14) << "Cache miss" << std::setw(14) << "Alloc (B)" << '\n';
+        for (const auto& [name, entry] : copy) {
+            os << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+                << std::setw(8) << entry.count
+                << std::setw(14) << entry.average_seconds() * 1e3
+                << std::setw(14) << entry.min_seconds * 1e3
+                << std::setw(14) << entry.max_seconds * 1e3
+                << std::setw(16) << entry.totals.tsc_cycles
+                << std::setw(16) << entry.totals.instructions
+                << std::setw(8) << std::setprecision(2) << entry.instructions_per_cycle()
+                << std::setw(14) << entry.totals.cache_misses
+                << std::setw(14) << entry.totals.bytes_allocated << '\n';
+        }
+    }
+};
+
+/**
+ * @brief Measures the enclosing scope and records it in a ProfileRegistry on destruction.
+ *
+ * lap(label) closes a split: the time since the previous lap is recorded as "name/label".
+ */
+class ProfileScope {
+    std::string name;
+    unsigned counters;
+    ProfileRegistry& registry;
+    Stopwatch stopwatch;
+    HardwareCounters* hardware = nullptr;
+    HardwareCounters::Reading hardware_start;
+    std::uint64_t tsc_start = 0;
+    std::uint64_t allocated_start = 0;
+    bool stopped = false;
+
+    static HardwareCounters& thread_counters() {
+        thread_local HardwareCounters counters;
+        return counters;
+    }
+
+public:
+    explicit ProfileScope(std::string name, unsigned counters = Counters::Time,
+        ProfileRegistry& registry = ProfileRegistry::global())
+        : name(std::move(name)), counters(counters), registry(registry) {
+        if (counters & Counters::Allocations) allocated_start = allocated_bytes();
+        if (counters & Counters::Hardware) {
+            hardware = &thread_counters();
+            hardware_start = hardware->read();
+        }
+        if (counters & Counters::Cycles) tsc_start = read_tsc();
+        stopwatch.start();
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    ~ProfileScope() { stop(); }
+
+    void lap(const std::string& label) {
+        ProfileSample sample;
+        sample.seconds = stopwatch.lap();
+        registry.record(name + "/" + label, sample);
+    }
+
+    // Ends the measurement early; returns the sample that was recorded
+    ProfileSample stop() {
+        ProfileSample sample;
+        if (stopped) return sample;
+        stopped = true;
+
+        stopwatch.stop();
+        sample.seconds = stopwatch.get_elapsed_time_seconds();
+        if (counters & Counters::Cycles) sample.tsc_cycles = read_tsc() - tsc_start;
+        if (hardware) HardwareCounters::difference(hardware_start, hardware->read(), sample);
+        if (counters & Counters::Allocations) sample.bytes_allocated = allocated_bytes() - allocated_start;
+        registry.record(name, sample);
+        return sample;
+    }
+};
+
+#endif // PROFILER_HPP
@@ -42,11 +42,14 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 class Stopwatch {
 private:
     std::chrono::steady_clock::time_point start_time;
     std::chrono::steady_clock::time_point end_time;
+    std::chrono::steady_clock::time_point last_lap_time;
+    std::vector<double> laps; // Split times in seconds, one per lap() call
     bool running;
 
     std::chrono::steady_clock::duration get_elapsed_duration() const {
@@ -59,6 +62,8 @@ public:
     void start() {
         if (!running) {
             start_time = std::chrono::steady_clock::now();
+            last_lap_time = start_time;
+            laps.clear();
             running = true;
         }
         else std::cerr << "Stopwatch is already running!" << std::endl;
@@ -72,7 +77,24 @@ public:
         else std::cerr << "Stopwatch is not running!" << std::endl;
     }
 
-    void reset() { running = false; }
+    void reset() {
+        running = false;
+        laps.clear();
+    }
+
+    // Records the time since the previous lap (or since start) and returns it in seconds
+    double lap() {
+        if (!running) {
+            std::cerr << "Stopwatch is not running!" << std::endl;
+            return 0.0;
+        }
+        auto now = std::chrono::steady_clock::now();
+        laps.push_back(std::chrono::duration<double>(now - last_lap_time).count());
+        last_lap_time = now;
+        return laps.back();
+    }
+
+    const std::vector<double>& get_laps() const { return laps; }
 
     double get_elapsed_time_seconds() const {
         return std::chrono::duration<double>(get_elapsed_duration()).count();
@@ -0,0 +1,221 @@
+/**************************************************************************************************
+    adaptive_sort:
+        A generic functor that takes in an std::vector<T>& and sorts it (in place), choosing the
+        algorithm from a single O(n) pass over the input:
+
+            - already sorted          -> nothing to do
+            - one descending run      -> reverse
+            - few, local inversions   -> insertion sort (wins on nearly sorted input, see main.cpp),
+                                         switching to introsort after shift_budget * n shifts
+            - few long runs           -> natural merge sort (TimSort-style run detection)
+            - mostly sorted           -> introsort (std::sort), which handles it well
+            - anything else           -> LSD radix sort for integers, introsort otherwise
+
+        The pass counts the runs and, for every descent, how far back the smaller element would
+        have to move past its neighbours (capped). That is only a hint: an element that belongs
+        far back behind a long ascending stretch still looks local, so insertion sort runs with
+        a budget of shifts and hands over to introsort when it is used up, which keeps the
+        whole sort O(n log n).
+**************************************************************************************************/
+
+#ifndef ADAPTIVE_SORT_HPP
+#define ADAPTIVE_SORT_HPP
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <cstdint>
+
+template <typename T>
+class adaptive_sort {
+public:
+    enum class strategy { none, reverse, insertion, natural_merge, radix, introsort };
+
+    // Result of the O(n) presortedness pass
+    struct presortedness {
+        size_t runs = 0;           // Maximal non-descending or strictly descending runs
+        size_t descents = 0;       // Adjacent pairs with arr[i] > arr[i + 1]
+        size_t max_displacement = 0; // Largest (capped) backwards move needed at a descent
+        bool descending = false;   // The whole input is one strictly descending run
+    };
+
+private:
+    static constexpr size_t small_size = 32;      // Below this, insertion sort always wins
+    static constexpr size_t displacement_cap = 8; // Insertion sort is chosen only for local disorder
+    static constexpr size_t min_run_length = 64;  // Natural merge needs runs at least this long on average
+    static constexpr size_t radix_threshold = 1 << 12;
+    static constexpr size_t shift_budget = 8;     // Shifts per element insertion sort may make
+
+    strategy last = strategy::none;
+
+    // Insertion sort that stops once it has shifted budget elements; returns whether it finished.
+    // Either way arr holds the same elements.
+    static bool insertion(std::vector<T>& arr, size_t budget) {
+        for (size_t i = 1; i < arr.size(); ++i) {
+            T key = std::move(arr[i]);
+            size_t j = i;
+            while (j > 0 && key < arr[j - 1]) {
+                if (budget-- == 0) {
+                    arr[j] = std::move(key);
+                    return false;
+                }
+                arr[j] = std::move(arr[j - 1]);
+                --j;
+            }
+            arr[j] = std::move(key);
+        }
+        return true;
+    }
+
+public:
+    // Stops early once neither insertion sort nor natural merge can be chosen, so random input
+    // only pays for a few percent of a pass. In that case runs/descents are lower bounds.
+    static presortedness analyze(const std::vector<T>& arr) {
+        presortedness p;
+        const size_t n = arr.size();
+        if (n == 0) return p;
+
+        size_t i = 0;
+        while (i < n) {
+            if (i > 0 && arr[i] < arr[i - 1]) ++p.descents; // Boundary between two runs
+            size_t j = i + 1;
+            if (j < n && arr[j] < arr[i]) {
+                while (j < n && arr[j] < arr[j - 1]) ++j; // Strictly descending run
+                p.descents += j - i - 1;
+                if (i == 0 && j == n) p.descending = true;
+            }
+            else {
+                while (j < n && !(arr[j] < arr[j - 1])) ++j; // Non-descending run
+            }
+            ++p.runs;
+            i = j;
+            if (p.runs * min_run_length > n && p.descents * displacement_cap > n) return p;
+        }
+
+        if (p.descending || p.descents * displacement_cap > n) return p;
+        for (size_t k = 1; k < n && p.max_displacement < displacement_cap; ++k) {
+            if (!(arr[k] < arr[k - 1])) continue;
+            size_t moved = 1;
+            while (moved < displacement_cap && moved < k && arr[k] < arr[k - 1 - moved]) ++moved;
+            p.max_displacement = std::max(p.max_displacement, moved);
+        }
+        return p;
+    }
+
+    static strategy choose(const std::vector<T>& arr, const presortedness& p) {
+        const size_t n = arr.size();
+        if (p.descents == 0) return strategy::none;
+        if (p.descending) return strategy::reverse;
+        if (n <= small_size) return strategy::insertion;
+        if (p.max_displacement < displacement_cap && p.descents * displacement_cap <= n) return strategy::insertion;
+        if (p.runs * min_run_length <= n) return strategy::natural_merge;
+        if (p.descents * 2 * displacement_cap <= n) return strategy::introsort;
+        if constexpr (std::is_integral_v<T> && sizeof(T) <= 8) {
+            if (n >= radix_threshold) return strategy::radix;
+        }
+        return strategy::introsort;
+    }
+
+    // Detects runs, reverses strictly descending ones, then merges neighbours pass by pass.
+    // Stable, O(n log runs).
+    static void natural_merge_sort(std::vector<T>& arr) {
+        const size_t n = arr.size();
+        if (n < 2) return;
+
+        std::vector<size_t> bounds{ 0 };
+        size_t i = 0;
+        while (i < n) {
+            size_t j = i + 1;
+            if (j < n && arr[j] < arr[i]) {
+                while (j < n && arr[j] < arr[j - 1]) ++j;
+                std::reverse(arr.begin() + i, arr.begin() + j);
+            }
+            else {
+                while (j < n && !(arr[j] < arr[j - 1])) ++j;
+            }
+            bounds.push_back(j);
+            i = j;
+        }
+
+        std::vector<T> buffer(n);
+        std::vector<T>* from = &arr;
+        std::vector<T>* to = &buffer;
+        while (bounds.size() > 2) {
+            std::vector<size_t> merged{ 0 };
+            for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+                size_t lo = bounds[r], mid = bounds[r + 1];
+                size_t hi = (r + 2 < bounds.size()) ? bounds[r + 2] : mid;
+                std::merge(std::make_move_iterator(from->begin() + lo), std::make_move_iterator(from->begin() + mid),
+                    std::make_move_iterator(from->begin() + mid), std::make_move_iterator(from->begin() + hi),
+                    to->begin() + lo);
+                merged.push_back(hi);
+            }
+            bounds.swap(merged);
+            std::swap(from, to);
+        }
+        if (from != &arr) std::move(from->begin(), from->end(), arr.begin());
+    }
+
+    // LSD radix sort on bytes; passes where every key shares the same byte are skipped
+    template <typename U = T>
+    static std::enable_if_t<std::is_integral_v<U>> radix_sort(std::vector<T>& arr) {
+        using key_type = std::make_unsigned_t<T>;
+        const key_type sign_flip = std::is_signed_v<T> ? key_type(key_type(1) << (sizeof(T) * 8 - 1)) : key_type(0);
+        auto key = [sign_flip](const T& v) { return static_cast<key_type>(static_cast<key_type>(v) ^ sign_flip); };
+
+        const size_t n = arr.size();
+        if (n < 2) return;
+        std::vector<T> buffer(n);
+        std::vector<T>* from = &arr;
+        std::vector<T>* to = &buffer;
+
+        for (size_t shift = 0; shift < sizeof(T) * 8; shift += 8) {
+            size_t count[257] = {};
+            for (const T& v : *from) ++count[((key(v) >> shift) & 0xFF) + 1];
+            if (count[((key((*from)[0]) >> shift) & 0xFF) + 1] == n) continue; // All keys share this byte
+
+            for (size_t b = 0; b < 256; ++b) count[b + 1] += count[b];
+            for (const T& v : *from) (*to)[count[(key(v) >> shift) & 0xFF]++] = v;
+            std::swap(from, to);
+        }
+        if (from != &arr) arr.swap(buffer);
+    }
+
+    void operator()(std::vector<T>& arr) {
+        last = choose(arr, analyze(arr));
+        switch (last) {
+        case strategy::none: break;
+        case strategy::reverse: std::reverse(arr.begin(), arr.end()); break;
+        case strategy::insertion:
+            // Up to small_size elements the budget covers insertion sort's worst case
+            if (!insertion(arr, std::max(shift_budget * arr.size(), small_size * small_size))) {
+                last = strategy::introsort;
+                std::sort(arr.begin(), arr.end());
+            }
+            break;
+        case strategy::natural_merge: natural_merge_sort(arr); break;
+        case strategy::radix:
+            if constexpr (std::is_integral_v<T>) radix_sort(arr);
+            break;
+        case strategy::introsort: std::sort(arr.begin(), arr.end()); break;
+        }
+    }
+
+    strategy last_strategy() const { return last; }
+
+    static std::string to_string(strategy s) {
+        switch (s) {
+        case strategy::none: return "none";
+        case strategy::reverse: return "reverse";
+        case strategy::insertion: return "insertion";
+        case strategy::natural_merge: return "natural_merge";
+        case strategy::radix: return "radix";
+        case strategy::introsort: return "introsort";
+        }
+        return "unknown";
+    }
+};
+
+#endif // ADAPTIVE_SORT_HPP
@@ -0,0 +1,94 @@
+// Compares adaptive_sort against each algorithm it can dispatch to, on every input
+// distribution and on strided_outliers, an input built to look nearly sorted to its
+// presortedness pass. Reports the best single choice and how far adaptive_sort is from it.
+
+#include<iostream>
+#include<iomanip>
+#include<vector>
+#include<string>
+#include<algorithm>
+#include<functional>
+#include<limits>
+
+#include "../adaptive_sort.hpp"
+#include "../insertion_sort.hpp"
+#include "../Stopwatch.hpp"
+#include "distributions.hpp"
+
+
+// Average time in milliseconds of sorting a fresh copy of input, runs times
+template<typename SortAlgorithm>
+double time_sort(SortAlgorithm sort_algorithm, const std::vector<int>& input, int runs) {
+    double total_time = 0.0;
+    for (int i = 0; i < runs; ++i) {
+        std::vector<int> arr = input;
+        Stopwatch stopwatch;
+        stopwatch.start();
+        sort_algorithm(arr);
+        stopwatch.stop();
+        total_time += stopwatch.get_elapsed_time_milliseconds();
+    }
+    return total_time / runs;
+}
+
+
+// Every 8th element is small and rising, the rest are large: each small one is only a step out
+// of place next to its neighbours but belongs far back, so plain insertion sort is quadratic
+std::vector<int> strided_outliers(size_t size) {
+    std::vector<int> arr(size);
+    for (size_t i = 0; i < size; ++i) arr[i] = (i % 8 == 0) ? static_cast<int>(i / 8) : 10000000 + static_cast<int>(i);
+    return arr;
+}
+
+
+int main() {
+    const int runs = 5;
+    const std::vector<size_t> sizes = { 10000, 1000000 };
+    const size_t insertion_limit = 20000; // Insertion sort on random input above this takes minutes
+
+    using candidate = std::pair<std::string, std::function<void(std::vector<int>&)>>;
+    const std::vector<candidate> candidates = {
+        { "introsort", [](std::vector<int>& arr) { std::sort(arr.begin(), arr.end()); } },
+        { "natural_merge", [](std::vector<int>& arr) { adaptive_sort<int>::natural_merge_sort(arr); } },
+        { "radix", [](std::vector<int>& arr) { adaptive_sort<int>::radix_sort(arr); } },
+        { "insertion", insertion_sort<int>() },
+    };
+
+    distribution_generator generator(2024);
+
+    std::cout << std::left << std::setw(17) << "Distribution" << std::setw(10) << "Size"
+        << std::setw(15) << "Best" << std::setw(12) << "Best (ms)"
+        << std::setw(15) << "Adaptive" << std::setw(15) << "Adaptive (ms)" << "Ratio\n";
+
+    for (size_t size : sizes) {
+        std::vector<std::pair<std::string, std::vector<int>>> inputs;
+        for (distribution input : all_distributions()) inputs.emplace_back(to_string(input), generator(input, size));
+        inputs.emplace_back("strided_outliers", strided_outliers(size));
+
+        for (const auto& [input_name, arr] : inputs) {
+            adaptive_sort<int> adaptive;
+            double adaptive_time = time_sort(std::ref(adaptive), arr, runs);
+
+            std::string best_name;
+            double best_time = std::numeric_limits<double>::max();
+            for (const auto& [name, sort_algorithm] : candidates) {
+                // Insertion sort is only worth timing where adaptive_sort finished with it (so its
+                // work stayed within the shift budget), otherwise it never wins
+                if (name == "insertion" && size > insertion_limit && adaptive.last_strategy() != adaptive_sort<int>::strategy::insertion) continue;
+
+                double time = time_sort(sort_algorithm, arr, runs);
+                if (time < best_time) {
+                    best_time = time;
+                    best_name = name;
+                }
+            }
+
+            std::cout << std::left << std::setw(17) << input_name << std::setw(10) << size
+                << std::setw(15) << best_name << std::setw(12) << std::fixed << std::setprecision(3) << best_time
+                << std::setw(15) << adaptive_sort<int>::to_string(adaptive.last_strategy())
+                << std::setw(15) << adaptive_time << std::setprecision(2) << adaptive_time / best_time << "\n";
+        }
+    }
+
+    return 0;
+}
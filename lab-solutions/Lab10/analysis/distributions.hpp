@@ -0,0 +1,214 @@
+#ifndef DISTRIBUTIONS_HPP
+#define DISTRIBUTIONS_HPP
+
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Input shapes used to drive the sorting benchmarks.
+ *
+ * Each distribution exercises a different best/average/worst case of the sorters, so the
+ * benchmark no longer needs std::sort/std::reverse lines commented in and out by hand.
+ */
+enum class distribution {
+    random,
+    sorted,
+    reversed,
+    nearly_sorted,
+    few_unique,
+    organ_pipe,
+    sawtooth,
+    zipf
+};
+
+inline std::string to_string(distribution d) {
+    switch (d) {
+    case distribution::random: return "random";
+    case distribution::sorted: return "sorted";
+    case distribution::reversed: return "reversed";
+    case distribution::nearly_sorted: return "nearly_sorted";
+    case distribution::few_unique: return "few_unique";
+    case distribution::organ_pipe: return "organ_pipe";
+    case distribution::sawtooth: return "sawtooth";
+    case distribution::zipf: return "zipf";
+    }
+    return "unknown";
+}
+
+inline const std::vector<distribution>& all_distributions() {
+    static const std::vector<distribution> all = {
+        distribution::random, distribution::sorted, distribution::reversed,
+        distribution::nearly_sorted, distribution::few_unique, distribution::organ_pipe,
+        distribution::sawtooth, distribution::zipf
+    };
+    return all;
+}
+
+/**
+ * @brief Generates benchmark inputs of a given distribution.
+ *
+ * Large inputs (the generator is meant to handle 10^8 elements) are filled in parallel. Every
+ * worker owns an independent std::mt19937_64 stream seeded from (seed, worker index), so the
+ * output for a given seed and thread count is reproducible and no RNG state is shared.
+ */
+class distribution_generator {
+    std::uint64_t seed;
+    unsigned threads;
+
+    int max_value = 999999;        // Upper bound of the random values, same range as Benchmark
+    size_t swaps_per_1000 = 10;    // nearly_sorted: number of random swaps per 1000 elements
+    int unique_values = 16;        // few_unique: number of distinct keys
+    size_t sawtooth_period = 1000; // sawtooth: length of each ascending run
+    double zipf_exponent = 1.0;    // zipf: skew parameter s
+    int zipf_universe = 10000;     // zipf: number of distinct ranks
+
+    // Parallel loop over [0, n), fill(begin, end, rng) writes one contiguous chunk
+    template<typename Fill>
+    void parallel_fill(size_t n, Fill fill) const {
+        const size_t min_chunk = 1 << 16; // Not worth spawning a thread for less
+        unsigned workers = static_cast<unsigned>(std::min<size_t>(threads, (n + min_chunk - 1) / min_chunk));
+        if (workers <= 1) {
+            std::mt19937_64 rng = make_stream(0);
+            fill(0, n, rng);
+            return;
+        }
+
+        std::vector<std::thread> pool;
+        size_t chunk = (n + workers - 1) / workers;
+        for (unsigned w = 0; w < workers; ++w) {
+            size_t begin = w * chunk;
+            size_t end = std::min(n, begin + chunk);
+            if (begin >= end) break;
+            pool.emplace_back([this, w, begin, end, &fill]() {
+                std::mt19937_64 rng = make_stream(w);
+                fill(begin, end, rng);
+                });
+        }
+        for (auto& t : pool) t.join();
+    }
+
+    std::mt19937_64 make_stream(unsigned worker) const {
+        std::seed_seq seq{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32), worker };
+        return std::mt19937_64(seq);
+    }
+
+    // Cumulative distribution over ranks 1..zipf_universe, sampled by binary search
+    std::vector<double> zipf_cdf() const {
+        std::vector<double> cdf(zipf_universe);
+        double total = 0.0;
+        for (int k = 1; k <= zipf_universe; ++k) {
+            total += 1.0 / std::pow(static_cast<double>(k), zipf_exponent);
+            cdf[k - 1] = total;
+        }
+        for (double& c : cdf) c /= total;
+        return cdf;
+    }
+
+public:
+    explicit distribution_generator(std::uint64_t seed = std::random_device{}(),
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency()))
+        : seed(seed), threads(std::max(1u, threads)) {
+    }
+
+    distribution_generator& set_max_value(int value) { max_value = value; return *this; }
+    distribution_generator& set_swaps_per_1000(size_t swaps) { swaps_per_1000 = swaps; return *this; }
+    distribution_generator& set_unique_values(int count) { unique_values = std::max(1, count); return *this; }
+    distribution_generator& set_sawtooth_period(size_t period) { sawtooth_period = std::max<size_t>(1, period); return *this; }
+    distribution_generator& set_zipf(double exponent, int universe) {
+        zipf_exponent = exponent;
+        zipf_universe = std::max(1, universe);
+        return *this;
+    }
+
+    std::vector<int> operator()(distribution d, size_t n) const {
+        std::vector<int> arr(n);
+        fill(d, arr);
+        return arr;
+    }
+
+    void fill(distribution d, std::vector<int>& arr) const {
+        const size_t n = arr.size();
+        if (n == 0) return;
+        int* out = arr.data();
+
+        // Map a position onto [0, max_value] so ordered shapes share the random value range
+        auto scaled = [this, n](size_t i) {
+            return static_cast<int>((static_cast<double>(i) / n) * max_value);
+            };
+
+        switch (d) {
+        case distribution::random:
+            parallel_fill(n, [&](size_t b, size_t e, std::mt19937_64& rng) {
+                std::uniform_int_distribution<int> dist(0, max_value);
+                for (size_t i = b; i < e; ++i) out[i] = dist(rng);
+                });
+            break;
+
+        case distribution::sorted:
+            parallel_fill(n, [&](size_t b, size_t e, std::mt19937_64&) {
+                for (size_t i = b; i < e; ++i) out[i] = scaled(i);
+                });
+            break;
+
+        case distribution::reversed:
+            parallel_fill(n, [&](size_t b, size_t e, std::mt19937_64&) {
+                for (size_t i = b; i < e; ++i) out[i] = scaled(n - 1 - i);
+                });
+            break;
+
+        case distribution::nearly_sorted: {
+            fill(distribution::sorted, arr);
+            // The swaps touch arbitrary positions, so they run on a single stream
+            std::mt19937_64 rng = make_stream(0);
+            std::uniform_int_distribution<size_t> pos(0, n - 1);
+            size_t k = std::max<size_t>(1, n * swaps_per_1000 / 1000);
+            for (size_t s = 0; s < k; ++s) std::swap(arr[pos(rng)], arr[pos(rng)]);
+            break;
+        }
+
+        case distribution::few_unique:
+            parallel_fill(n, [&](size_t b, size_t e, std::mt19937_64& rng) {
+                std::uniform_int_distribution<int> dist(0, unique_values - 1);
+                int step = std::max(1, max_value / unique_values);
+                for (size_t i = b; i < e; ++i) out[i] = dist(rng) * step;
+                });
+            break;
+
+        case distribution::organ_pipe:
+            // Ascending to the middle, then descending back down
+            parallel_fill(n, [&](size_t b, size_t e, std::mt19937_64&) {
+                for (size_t i = b; i < e; ++i) out[i] = scaled(2 * std::min(i, n - 1 - i));
+                });
+            break;
+
+        case distribution::sawtooth:
+            parallel_fill(n, [&](size_t b, size_t e, std::mt19937_64&) {
+                for (size_t i = b; i < e; ++i) {
+                    size_t offset = i % sawtooth_period;
+                    out[i] = static_cast<int>((static_cast<double>(offset) / sawtooth_period) * max_value);
+                }
+                });
+            break;
+
+        case distribution::zipf: {
+            std::vector<double> cdf = zipf_cdf();
+            parallel_fill(n, [&](size_t b, size_t e, std::mt19937_64& rng) {
+                std::uniform_real_distribution<double> u(0.0, 1.0);
+                for (size_t i = b; i < e; ++i) {
+                    auto it = std::lower_bound(cdf.begin(), cdf.end(), u(rng));
+                    out[i] = static_cast<int>(std::min<std::ptrdiff_t>(it - cdf.begin(), zipf_universe - 1));
+                }
+                });
+            break;
+        }
+        }
+    }
+};
+
+#endif // DISTRIBUTIONS_HPP
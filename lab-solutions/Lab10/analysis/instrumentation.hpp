@@ -0,0 +1,154 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Comparison and swap (element move) counts reported by an instrumented sort.
+ *
+ * 64-bit so the quadratic sorts do not overflow past ~65k elements. Supports structured
+ * bindings: auto [comparisons, swaps] = sorting_algorithms<int>::insertion_sort(arr);
+ */
+struct operation_counts {
+    std::uint64_t comparisons = 0;
+    std::uint64_t swaps = 0;
+
+    operation_counts& operator+=(const operation_counts& other) {
+        comparisons += other.comparisons;
+        swaps += other.swaps;
+        return *this;
+    }
+};
+
+//---------------------------------- Counting policies ----------------------------------//
+// A policy is passed as a template argument to the instrumented code. Every call on
+// no_counting is an empty inline function, so a sort instantiated with it compiles to the
+// same code as the uninstrumented version.
+
+struct no_counting {
+    static constexpr bool enabled = false;
+    void count_comparison() {}
+    void count_swap() {}
+    operation_counts counts() const { return {}; }
+    void reset() {}
+};
+
+// Plain counters, owned by one thread (each benchmark worker has its own instance)
+struct counting {
+    static constexpr bool enabled = true;
+    std::uint64_t comparisons = 0;
+    std::uint64_t swaps = 0;
+
+    void count_comparison() { ++comparisons; }
+    void count_swap() { ++swaps; }
+    operation_counts counts() const { return { comparisons, swaps }; }
+    void reset() { comparisons = swaps = 0; }
+};
+
+//---------------------------------- Generic wrappers ----------------------------------//
+
+/**
+ * @brief Comparator that forwards to Compare and counts every call on a policy.
+ *
+ * Lets any comparator-based algorithm be measured, e.g.
+ *     counting policy;
+ *     std::sort(arr.begin(), arr.end(), counting_compare<int, counting>(policy));
+ */
+template<typename T, typename Policy, typename Compare = std::less<T>>
+class counting_compare {
+    Policy* policy;
+    Compare compare;
+public:
+    explicit counting_compare(Policy& policy, Compare compare = Compare()) : policy(&policy), compare(compare) {}
+
+    bool operator()(const T& a, const T& b) const {
+        policy->count_comparison();
+        return compare(a, b);
+    }
+};
+
+/**
+ * @brief Value wrapper that counts every copy or move, by construction or assignment, as a swap.
+ *
+ * Algorithms that do not take a comparator (or that move elements through their own
+ * iterators) can be measured by sorting a std::vector<counted<T, Policy>> instead. The
+ * counters are reached through a thread-local pointer installed by counting_scope, so
+ * elements stay the size of T and each thread counts into its own policy.
+ */
+template<typename T, typename Policy>
+class counted {
+    T value;
+
+    static Policy*& active() {
+        thread_local Policy* policy = nullptr;
+        return policy;
+    }
+
+public:
+    counted() = default;
+    counted(const T& v) : value(v) {}
+
+    // T tmp = std::move(x) moves an element just like an assignment does
+    counted(const counted& other) : value(other.value) {
+        if (Policy* p = active()) p->count_swap();
+    }
+
+    counted(counted&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : value(std::move(other.value)) {
+        if (Policy* p = active()) p->count_swap();
+    }
+
+    counted& operator=(const counted& other) {
+        if (Policy* p = active()) p->count_swap();
+        value = other.value;
+        return *this;
+    }
+
+    counted& operator=(counted&& other) {
+        if (Policy* p = active()) p->count_swap();
+        value = std::move(other.value);
+        return *this;
+    }
+
+    const T& get() const { return value; }
+
+    friend bool operator<(const counted& a, const counted& b) {
+        if (Policy* p = active()) p->count_comparison();
+        return a.value < b.value;
+    }
+
+    friend bool operator>(const counted& a, const counted& b) { return b < a; }
+
+    // Installs a policy for the current thread for the lifetime of the scope
+    class counting_scope {
+        Policy* previous;
+    public:
+        explicit counting_scope(Policy& policy) : previous(active()) { active() = &policy; }
+        ~counting_scope() { active() = previous; }
+        counting_scope(const counting_scope&) = delete;
+        counting_scope& operator=(const counting_scope&) = delete;
+    };
+};
+
+/**
+ * @brief Runs sort on a counted copy of arr and writes the sorted values back.
+ *
+ * sort receives a std::vector<counted<T, Policy>>&, e.g.
+ *     auto [c, s] = measure(arr, [](auto& v) { std::stable_sort(v.begin(), v.end()); });
+ */
+template<typename Policy = counting, typename T, typename Sort>
+operation_counts measure(std::vector<T>& arr, Sort sort) {
+    std::vector<counted<T, Policy>> wrapped(arr.begin(), arr.end());
+    Policy policy;
+    {
+        typename counted<T, Policy>::counting_scope scope(policy);
+        sort(wrapped);
+    }
+    for (size_t i = 0; i < arr.size(); ++i) arr[i] = wrapped[i].get();
+    return policy.counts();
+}
+
+#endif // INSTRUMENTATION_HPP
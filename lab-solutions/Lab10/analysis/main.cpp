@@ -1,90 +1,110 @@
-
 #include<iostream>
 #include<vector>
 #include<random>
-#include<algorithm> // for std::generate
 #include<fstream> // For file operations
+#include<thread>
+#include<atomic>
+#include<mutex>
 
 #include "sorting_algorithms.hpp"
+#include "distributions.hpp"
 
 
 class Benchmark {
-    std::mt19937 rng{ std::random_device{}() };
-    std::uniform_int_distribution<int> dist;
+    distribution_generator generator;
 public:
-    Benchmark() : dist(0, 999999) {
-        std::random_device rd;
-        rng.seed(rd());
-    }
+    // Each sweep worker owns its Benchmark, so generation runs on the calling thread only
+    explicit Benchmark(std::uint64_t seed = std::random_device{}()) : generator(seed, 1) {}
 
 
     template<typename SortAlgorithm>
-    std::pair<int, int> benchmark(SortAlgorithm sort_algorithm, int runs, int size = 1000) {
-        int comparisons = 0;
-        int swaps = 0;
+    operation_counts benchmark(SortAlgorithm sort_algorithm, distribution input, int runs, int size = 1000) {
+        operation_counts total;
 
-        double total_time = 0.0;
         for (int i = 0; i < runs; ++i) {
-            std::vector<int> arr(size);
-            std::generate(arr.begin(), arr.end(), [&]() { return dist(rng); });
-
-            // Best case for insertion_sort, selection_sort, and shell_sort
-            // std::sort(arr.begin(), arr.end()); // Comment out for average case
-            // std::reverse(arr.begin(), arr.end()); // Reverse the sorted array, worst case.
-
-            auto [c, s] = sort_algorithm(arr); // For insertion_sort, selection_sort, and shell_sort
-            comparisons += c;
-            swaps += s;
+            std::vector<int> arr = generator(input, size);
+            total += sort_algorithm(arr); // For insertion_sort, selection_sort, and shell_sort
         }
 
         //  Return average comparisons and swaps (do not print anything here)
-        int avg_comparisons = comparisons / runs;
-        int avg_swaps = swaps / runs;
-
-        return { avg_comparisons, avg_swaps };
+        return { total.comparisons / runs, total.swaps / runs };
     }
 };
 
 
-int main() {
-    Benchmark benchmarker;
-    const int runs = 5; // Number of test runs
-    const int max_size = 10000; // Maximum size of the array to sort
+struct sweep_row {
+    int size = 0;
+    operation_counts insertion, selection, shell;
+};
 
-    // Open a csv file to write the results
-    std::ofstream file("benchmark_results.csv");
-    if (!file.is_open()) {
-        std::cerr << "Error opening file for writing." << std::endl;
-        return 1;
-    }
+// Benchmarks every size on all cores. Workers pull the next size from a shared atomic index;
+// each row is written by exactly one worker, so no locking is needed for the results.
+std::vector<sweep_row> run_sweep(distribution input, const std::vector<int>& sizes, int runs) {
+    std::vector<sweep_row> rows(sizes.size());
+    std::atomic<size_t> next{ 0 };
+    std::atomic<size_t> completed{ 0 };
+    std::mutex progress_mutex;
+
+    auto worker = [&](std::uint64_t seed) {
+        Benchmark benchmarker(seed);
+        for (size_t k = next.fetch_add(1); k < sizes.size(); k = next.fetch_add(1)) {
+            // Largest sizes are handed out first so the sweep ends with the cheap ones
+            size_t index = sizes.size() - 1 - k;
+            sweep_row& row = rows[index];
+            row.size = sizes[index];
+            row.insertion = benchmarker.benchmark(sorting_algorithms<int>::insertion_sort, input, runs, row.size);
+            row.selection = benchmarker.benchmark(sorting_algorithms<int>::selection_sort, input, runs, row.size);
+            row.shell = benchmarker.benchmark(sorting_algorithms<int>::shell_sort, input, runs, row.size);
+
+            size_t done = completed.fetch_add(1) + 1;
+            std::lock_guard<std::mutex> lock(progress_mutex);
+            std::cout << to_string(input) << ": completed " << done << "/" << sizes.size() << " sizes..." << "\r";
+        }
+        };
 
-    // Write the header to the CSV file
-    file << "Size,Insertion Compares,Insertion Swaps,Selection Compares,Selection Swaps,Shell Compares,Shell Swaps\n";
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::random_device rd;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker, (static_cast<std::uint64_t>(rd()) << 32) | rd());
+    for (auto& t : pool) t.join();
+    return rows;
+}
 
-    for (int i = 1; i < max_size; ++i) {
-        auto [average_comparisons_insertion, average_swaps_insertion] =
-            benchmarker.benchmark(sorting_algorithms<int>::insertion_sort, runs, i);
 
-        auto [average_comparisons_selection, average_swaps_selection] =
-            benchmarker.benchmark(sorting_algorithms<int>::selection_sort, runs, i);
+int main() {
+    const int runs = 5; // Number of test runs
+    const int max_size = 10000; // Maximum size of the array to sort
 
-        auto [average_comparisons_shell, average_swaps_shell] =
-            benchmarker.benchmark(sorting_algorithms<int>::shell_sort, runs, i);
+    std::vector<int> sizes;
+    for (int i = 1; i < max_size; ++i) sizes.push_back(i);
 
-        // Write the results to the CSV file
-        file << i << ","
-            << average_comparisons_insertion << ","
-            << average_swaps_insertion << ","
-            << average_comparisons_selection << ","
-            << average_swaps_selection << ","
-            << average_comparisons_shell << ","
-            << average_swaps_shell << "\n";
+    // One CSV per input distribution, e.g. benchmark_results_reversed.csv
+    for (distribution input : all_distributions()) {
+        std::string file_name = "benchmark_results_" + to_string(input) + ".csv";
+        std::ofstream file(file_name);
+        if (!file.is_open()) {
+            std::cerr << "Error opening " << file_name << " for writing." << std::endl;
+            return 1;
+        }
 
-        std::cout << "Completed size " << i << "..." << "\r";
-    }
+        std::vector<sweep_row> rows = run_sweep(input, sizes, runs);
+
+        // Write the header and the results to the CSV file
+        file << "Size,Insertion Compares,Insertion Swaps,Selection Compares,Selection Swaps,Shell Compares,Shell Swaps\n";
+        for (const sweep_row& row : rows) {
+            file << row.size << ","
+                << row.insertion.comparisons << ","
+                << row.insertion.swaps << ","
+                << row.selection.comparisons << ","
+                << row.selection.swaps << ","
+                << row.shell.comparisons << ","
+                << row.shell.swaps << "\n";
+        }
 
-    std::cout << "Benchmarking completed. Results saved to benchmark_results.csv." << std::endl;
-    file.close(); // Close the file after writing
+        std::cout << "\nResults saved to " << file_name << "." << std::endl;
+        file.close(); // Close the file after writing
+    }
 
+    std::cout << "Benchmarking completed." << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -4,50 +4,52 @@
 #include <vector>
 #include <utility>
 
-template <typename T>
+#include "instrumentation.hpp"
+
+// Policy selects the instrumentation: counting (default), or no_counting
+// to compile the counters out and time the bare algorithm.
+template <typename T, typename Policy = counting>
 class sorting_algorithms {
 public:
-    static std::pair<int, int> insertion_sort(std::vector<T>& arr) {
-        int comparisons = 0;
-        int swaps = 0;
+    static operation_counts insertion_sort(std::vector<T>& arr) {
+        Policy counter;
         for (size_t i = 1; i < arr.size(); ++i) {
             T key = arr[i];
-            int j = static_cast<int>(i) - 1;
-            while (j >= 0) {
-                ++comparisons;
-                if (arr[j] > key) {
-                    arr[j + 1] = arr[j]; ++swaps; // Move element
+            size_t j = i;
+            while (j > 0) {
+                counter.count_comparison();
+                if (arr[j - 1] > key) {
+                    arr[j] = arr[j - 1]; counter.count_swap(); // Move element
                     --j;
                 }
                 else break;
             }
-            arr[j + 1] = key;
-            ++swaps;  // Insertion of key
+            arr[j] = key;
+            counter.count_swap();  // Insertion of key
         }
-        return { comparisons, swaps };
+        return counter.counts();
     }
 
-    static std::pair<int, int> selection_sort(std::vector<T>& arr) {
+    static operation_counts selection_sort(std::vector<T>& arr) {
         size_t n = arr.size();
-        int comparisons = 0;
-        int swaps = 0;
+        Policy counter;
+        if (n < 2) return counter.counts();
         for (size_t i = 0; i < n - 1; ++i) {
             size_t min_index = i;
             for (size_t j = i + 1; j < n; ++j) {
-                ++comparisons;
+                counter.count_comparison();
                 if (arr[j] < arr[min_index]) min_index = j;
             }
             std::swap(arr[i], arr[min_index]);
-            ++swaps;
+            counter.count_swap();
         }
 
-        return { comparisons, swaps };
+        return counter.counts();
     }
 
-    static std::pair<int, int> shell_sort(std::vector<T>& arr) {
+    static operation_counts shell_sort(std::vector<T>& arr) {
         size_t n = arr.size();
-        int comparisons = 0;
-        int swaps = 0;
+        Policy counter;
 
         // Using the Knuth sequence for gap calculation
         size_t gap = 1;
@@ -58,20 +60,19 @@ public:
                 T temp = arr[i];
                 size_t j = i;
                 while (j >= gap) {
-                    ++comparisons;
+                    counter.count_comparison();
                     if (arr[j - gap] > temp) {
-                        arr[j] = arr[j - gap]; ++swaps; // Move element
+                        arr[j] = arr[j - gap]; counter.count_swap(); // Move element
                         j -= gap;
                     }
                     else break;
                 }
-                arr[j] = temp; ++swaps; // Insertion of temp
+                arr[j] = temp; counter.count_swap(); // Insertion of temp
             }
             gap /= 3; // Reduce the gap for the next iteration
         }
-        return { comparisons, swaps };
+        return counter.counts();
     }
 };
 
-#endif // SORTING_ALGORITHMS_HPP    
-
+#endif // SORTING_ALGORITHMS_HPP
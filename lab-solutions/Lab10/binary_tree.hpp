@@ -30,6 +30,7 @@
 
 #include <iostream>
 #include <vector>
+#include <type_traits>
 
 template <typename T>
 class BinaryTree {
@@ -58,6 +59,16 @@ private:
         }
     }
 
+    // Returns false once visitor asked to stop
+    template <typename Visitor>
+    bool for_each_in_order(Node* node, Visitor& visitor) const {
+        if (node == nullptr) return true;
+        if (!for_each_in_order(node->left, visitor)) return false;
+        if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, const T&>>) visitor(node->data);
+        else if (!visitor(node->data)) return false;
+        return for_each_in_order(node->right, visitor);
+    }
+
     void clear(Node* node) {
         if (node != nullptr) {
             clear(node->left);
@@ -79,6 +90,13 @@ public:
         return result;
     }
 
+    // Streams the values in ascending order to visitor(const T&) without building a vector. If the
+    // visitor returns a bool, false stops the traversal (e.g. after the k smallest values).
+    template <typename Visitor>
+    bool for_each_in_order(Visitor visitor) const {
+        return for_each_in_order(root, visitor);
+    }
+
     void operator()(std::vector<T>& arr) {
         for (const auto& value : arr) insert(value);
         arr.clear();
@@ -0,0 +1,328 @@
+/**************************************************************************************************
+    external_sort:
+        A generic functor that sorts a binary file of fixed-width records that may be larger than
+        RAM, writing the result to a second file:
+
+            external_sort<Record> sorter(256 << 20);         // 256 MB memory budget
+            sorter("input.bin", "output.bin");
+
+        Phase 1 reads the input in chunks of the memory budget with large buffered reads (the
+        next chunk is read while the current one is sorted), one slice per thread, sorts the
+        slices in place in parallel with the in-memory sorters and writes each slice out as a
+        sorted run.
+
+        Phase 2 merges the runs with a loser tree (one comparison per tree level for every
+        record output). Every run is read through a double buffer whose next block is fetched
+        asynchronously, and output blocks are written asynchronously as well. If there are more
+        runs than max_fan_in, groups of runs are merged into intermediate runs first.
+**************************************************************************************************/
+
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <future>
+#include <thread>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <stdexcept>
+#include <type_traits>
+#include <atomic>
+#include <random>
+
+#include "adaptive_sort.hpp"
+#include "Stopwatch.hpp"
+
+struct external_sort_stats {
+    size_t bytes = 0;          // Size of the input
+    size_t runs = 0;           // Sorted runs produced by phase 1
+    size_t merge_passes = 0;   // Merge passes in phase 2 (1 unless runs > max_fan_in)
+    double run_seconds = 0.0;  // Time spent reading, sorting and writing runs
+    double merge_seconds = 0.0;
+
+    double throughput_mb_per_second() const {
+        double seconds = run_seconds + merge_seconds;
+        return seconds > 0.0 ? (bytes / (1024.0 * 1024.0)) / seconds : 0.0;
+    }
+};
+
+template <typename Record, typename Compare = std::less<Record>>
+class external_sort {
+    static_assert(std::is_trivially_copyable_v<Record>, "external_sort requires fixed-width, trivially copyable records");
+
+    size_t memory_budget;   // Bytes of records held in memory during phase 1
+    unsigned threads;
+    size_t block_records;   // Records per I/O block in phase 2
+    size_t max_fan_in;
+    std::filesystem::path temp_directory;
+    Compare compare;
+    external_sort_stats last_stats;
+
+    // Reads up to count records, returns the number of records read
+    static size_t read_records(std::ifstream& in, Record* out, size_t count) {
+        in.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(count * sizeof(Record)));
+        return static_cast<size_t>(in.gcount()) / sizeof(Record);
+    }
+
+    static void write_records(std::ofstream& out, const Record* data, size_t count) {
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(Record)));
+        if (!out) throw std::runtime_error("external_sort: write failed");
+    }
+
+    void sort_slice(std::vector<Record>& slice) const {
+        if constexpr (std::is_same_v<Compare, std::less<Record>>) adaptive_sort<Record>{}(slice);
+        else std::sort(slice.begin(), slice.end(), compare);
+    }
+
+    //------------------------------------- I/O buffers -------------------------------------//
+
+    // Sequential reader over one run with the next block prefetched asynchronously
+    class run_reader {
+        std::ifstream in;
+        std::vector<Record> current, next;
+        size_t position = 0, size = 0;
+        std::future<size_t> pending;
+
+        void prefetch() {
+            pending = std::async(std::launch::async, [this]() { return read_records(in, next.data(), next.size()); });
+        }
+
+    public:
+        run_reader(const std::filesystem::path& path, size_t block_records)
+            : in(path, std::ios::binary), current(block_records), next(block_records) {
+            if (!in.is_open()) throw std::runtime_error("external_sort: could not open run " + path.string());
+            size = read_records(in, current.data(), current.size());
+            prefetch();
+        }
+
+        ~run_reader() { if (pending.valid()) pending.wait(); }
+
+        bool exhausted() const { return position == size; }
+        const Record& head() const { return current[position]; }
+
+        void advance() {
+            if (++position < size) return;
+            size = pending.get();
+            position = 0;
+            current.swap(next);
+            if (size > 0) prefetch();
+        }
+    };
+
+    // Buffered writer that hands full blocks to an asynchronous write
+    class async_writer {
+        std::ofstream out;
+        std::vector<Record> filling, flushing;
+        size_t count = 0;
+        std::future<void> pending;
+
+        void wait() { if (pending.valid()) pending.get(); }
+
+    public:
+        async_writer(const std::filesystem::path& path, size_t block_records)
+            : out(path, std::ios::binary | std::ios::trunc), filling(block_records), flushing(block_records) {
+            if (!out.is_open()) throw std::runtime_error("external_sort: could not open " + path.string());
+        }
+
+        ~async_writer() { if (pending.valid()) pending.wait(); }
+
+        void push(const Record& record) {
+            filling[count++] = record;
+            if (count == filling.size()) flush();
+        }
+
+        void flush() {
+            wait();
+            filling.swap(flushing);
+            size_t n = count;
+            count = 0;
+            pending = std::async(std::launch::async, [this, n]() { write_records(out, flushing.data(), n); });
+        }
+
+        void close() {
+            flush();
+            wait();
+            out.close();
+        }
+    };
+
+    //------------------------------------- Loser tree --------------------------------------//
+
+    // tree[0] holds the index of the current smallest head, tree[1..k-1] the losers of each
+    // match. Index k is a virtual source that beats everything, used only while building.
+    class loser_tree {
+        std::vector<std::unique_ptr<run_reader>>& sources;
+        const Compare& compare;
+        std::vector<size_t> tree;
+        size_t k;
+
+        bool beats(size_t a, size_t b) const {
+            if (a == k) return true;
+            if (b == k) return false;
+            if (sources[a]->exhausted()) return false;
+            if (sources[b]->exhausted()) return true;
+            if (compare(sources[a]->head(), sources[b]->head())) return true;
+            if (compare(sources[b]->head(), sources[a]->head())) return false;
+            return a < b; // Ties go to the earlier run, which keeps the merge stable
+        }
+
+        void replay(size_t source) {
+            size_t winner = source;
+            for (size_t node = (source + k) / 2; node > 0; node /= 2)
+                if (beats(tree[node], winner)) std::swap(tree[node], winner);
+            tree[0] = winner;
+        }
+
+    public:
+        loser_tree(std::vector<std::unique_ptr<run_reader>>& sources, const Compare& compare)
+            : sources(sources), compare(compare), tree(std::max<size_t>(1, sources.size()), sources.size()), k(sources.size()) {
+            for (size_t s = k; s-- > 0;) replay(s);
+        }
+
+        bool empty() const { return k == 0 || sources[tree[0]]->exhausted(); }
+        const Record& top() const { return sources[tree[0]]->head(); }
+
+        void pop() {
+            size_t winner = tree[0];
+            sources[winner]->advance();
+            replay(winner);
+        }
+    };
+
+    // A new directory under temp_directory, like mkdtemp: create_directory only returns true if
+    // it made the directory, so a name another process or thread already took is never shared
+    std::filesystem::path make_work_directory() const {
+        static std::atomic<unsigned> instance{ 0 };
+        std::filesystem::create_directories(temp_directory);
+        std::random_device random;
+        for (;;) {
+            std::filesystem::path work = temp_directory / ("external_sort_" + std::to_string(random()) + "_" + std::to_string(instance++));
+            if (std::filesystem::create_directory(work)) return work;
+        }
+    }
+
+    //---------------------------------------- Phases ---------------------------------------//
+
+    std::vector<std::filesystem::path> create_runs(const std::string& input_path, const std::filesystem::path& work) {
+        std::ifstream in(input_path, std::ios::binary);
+        if (!in.is_open()) throw std::runtime_error("external_sort: could not open input " + input_path);
+
+        // The budget covers the chunk being sorted and the chunk being read. A chunk is read
+        // straight into one vector per thread, so every slice is sorted in place.
+        const size_t slice_records = std::max<size_t>(1, memory_budget / sizeof(Record) / 2 / threads);
+        std::vector<std::vector<Record>> chunk(threads, std::vector<Record>(slice_records)), next_chunk = chunk;
+        std::vector<std::filesystem::path> runs;
+
+        // Slices only come back short at the end of the input, after which every read is empty
+        auto read_chunk = [&in](std::vector<std::vector<Record>>& slices) {
+            size_t size = 0;
+            for (auto& slice : slices) {
+                size_t count = read_records(in, slice.data(), slice.size());
+                if (count < slice.size()) slice.resize(count);
+                size += count;
+            }
+            return size;
+        };
+
+        size_t size = read_chunk(chunk);
+        while (size > 0) {
+            last_stats.bytes += size * sizeof(Record);
+            // Read the next chunk while this one is sorted and written
+            std::future<size_t> pending = std::async(std::launch::async, [&]() { return read_chunk(next_chunk); });
+
+            // get() rethrows a failed write here, after which the remaining futures wait for
+            // their slices as they are destroyed
+            std::vector<std::future<void>> sorted;
+            for (auto& slice : chunk) {
+                if (slice.empty()) continue;
+                runs.push_back(work / ("run_" + std::to_string(runs.size()) + ".bin"));
+                sorted.push_back(std::async(std::launch::async, [this, &slice, path = runs.back()]() {
+                    sort_slice(slice);
+                    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                    write_records(out, slice.data(), slice.size());
+                    }));
+            }
+            for (auto& future : sorted) future.get();
+
+            size = pending.get();
+            chunk.swap(next_chunk);
+        }
+        return runs;
+    }
+
+    void merge_runs(const std::vector<std::filesystem::path>& runs, const std::filesystem::path& output) const {
+        std::vector<std::unique_ptr<run_reader>> sources;
+        for (const auto& run : runs) sources.push_back(std::make_unique<run_reader>(run, block_records));
+
+        async_writer writer(output, block_records);
+        loser_tree tree(sources, compare);
+        while (!tree.empty()) {
+            writer.push(tree.top());
+            tree.pop();
+        }
+        writer.close();
+    }
+
+public:
+    explicit external_sort(size_t memory_budget = size_t(256) << 20,
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency()),
+        std::filesystem::path temp_directory = std::filesystem::temp_directory_path(),
+        Compare compare = Compare())
+        : memory_budget(std::max(memory_budget, sizeof(Record) * 2)), threads(std::max(1u, threads)),
+        block_records(std::max<size_t>(1, (size_t(1) << 20) / sizeof(Record))), max_fan_in(256),
+        temp_directory(std::move(temp_directory)), compare(compare) {
+    }
+
+    external_sort& set_block_bytes(size_t bytes) { block_records = std::max<size_t>(1, bytes / sizeof(Record)); return *this; }
+    external_sort& set_max_fan_in(size_t fan_in) { max_fan_in = std::max<size_t>(2, fan_in); return *this; }
+
+    external_sort_stats operator()(const std::string& input_path, const std::string& output_path) {
+        std::filesystem::path work = make_work_directory();
+
+        last_stats = external_sort_stats();
+        Stopwatch stopwatch;
+        try {
+            stopwatch.start();
+            std::vector<std::filesystem::path> runs = create_runs(input_path, work);
+            stopwatch.stop();
+            last_stats.run_seconds = stopwatch.get_elapsed_time_seconds();
+            last_stats.runs = runs.size();
+
+            stopwatch.reset();
+            stopwatch.start();
+            // Merge groups of max_fan_in runs until a single pass can produce the output
+            size_t generation = 0;
+            while (runs.size() > max_fan_in) {
+                std::vector<std::filesystem::path> merged;
+                for (size_t begin = 0; begin < runs.size(); begin += max_fan_in) {
+                    std::vector<std::filesystem::path> group(runs.begin() + begin, runs.begin() + std::min(runs.size(), begin + max_fan_in));
+                    merged.push_back(work / ("merge_" + std::to_string(generation) + "_" + std::to_string(merged.size()) + ".bin"));
+                    merge_runs(group, merged.back());
+                    for (const auto& run : group) std::filesystem::remove(run);
+                }
+                runs.swap(merged);
+                ++generation;
+                ++last_stats.merge_passes;
+            }
+            merge_runs(runs, output_path);
+            ++last_stats.merge_passes;
+            stopwatch.stop();
+            last_stats.merge_seconds = stopwatch.get_elapsed_time_seconds();
+        }
+        catch (...) {
+            std::filesystem::remove_all(work);
+            throw;
+        }
+
+        std::filesystem::remove_all(work);
+        return last_stats;
+    }
+
+    const external_sort_stats& stats() const { return last_stats; }
+};
+
+#endif // EXTERNAL_SORT_HPP
@@ -28,6 +28,7 @@
 #include<iostream>
 #include<vector>
 #include<random>
+#include<string>
 #include<algorithm> // for std::generate
 
 #include "binary_tree.hpp"
@@ -37,6 +38,10 @@
 
 #include "Stopwatch.hpp"
 
+// This is the only translation unit, so it installs MemoryTracker for the profile scopes
+#define PROFILE_ALLOCATIONS
+#include "Profiler.hpp"
+
 class Benchmark {
     std::mt19937 rng{ std::random_device{}() };
     std::uniform_int_distribution<int> dist;
@@ -47,8 +52,10 @@ public:
     }
 
 
+    // Every sort also runs in a ProfileScope named name, so the registry attributes its time to
+    // instructions, cache misses and allocations
     template<typename SortAlgorithm>
-    double benchmark(SortAlgorithm sort_algorithm, int runs, int size = 100000) {
+    double benchmark(const std::string& name, SortAlgorithm sort_algorithm, int runs, int size = 100000) {
         double total_time = 0.0;
         for (int i = 0; i < runs; ++i) {
             std::vector<int> arr(size);
@@ -59,7 +66,10 @@ public:
 
             Stopwatch stopwatch;
             stopwatch.start();
-            sort_algorithm(arr);
+            {
+                ProfileScope scope(name, Counters::All);
+                sort_algorithm(arr);
+            }
             stopwatch.stop();
 
             // If it's a BinaryTree, we need to call the clear method to clear the tree for the next run
@@ -77,20 +87,24 @@ int main() {
     const int runs = 5; // Number of test runs
 
     // Benchmarking Insertion Sort
-    double insertion_sort_time = benchmarker.benchmark(insertion_sort<int>(), runs);
+    double insertion_sort_time = benchmarker.benchmark("insertion_sort", insertion_sort<int>(), runs);
     std::cout << "Average Insertion Sort Time: " << insertion_sort_time << " seconds" << std::endl;
 
     // Benchmarking Selection Sort
-    double selection_sort_time = benchmarker.benchmark(selection_sort<int>(), runs);
+    double selection_sort_time = benchmarker.benchmark("selection_sort", selection_sort<int>(), runs);
     std::cout << "Average Selection Sort Time: " << selection_sort_time << " seconds" << std::endl;
 
     // Benchmarking Shell Sort
-    double shell_sort_time = benchmarker.benchmark(shell_sort<int>, runs);
+    double shell_sort_time = benchmarker.benchmark("shell_sort", shell_sort<int>, runs);
     std::cout << "Average Shell Sort Time: " << shell_sort_time << " seconds" << std::endl;
 
     // Benchmarking Binary Tree Inorder Traversal Sort
-    double binary_tree_time = benchmarker.benchmark(BinaryTree<int>(), runs);
+    double binary_tree_time = benchmarker.benchmark("binary_tree", BinaryTree<int>(), runs);
     std::cout << "Average Binary Tree Time: " << binary_tree_time << " seconds" << std::endl;
 
+    // Per algorithm: instructions per cycle and cache misses tell compute from memory stalls
+    std::cout << std::endl;
+    ProfileRegistry::global().report(std::cout);
+
     return 0;
 }
\ No newline at end of file
@@ -33,162 +33,8 @@
 #include <iostream>
 #include <vector>
 
+#include "file_system.hpp"
 
-struct File {
-    std::string file_name;
-    std::string file_type;
-    int file_size;
-
-    File* left;
-    File* right;
-
-    File(std::string _fn, std::string _ft, int _fs) :
-        file_name(_fn), file_type(_ft), file_size(_fs), left(nullptr), right(nullptr) {
-    }
-
-    friend std::ostream& operator<<(std::ostream& os, const File& file) {
-        os << "File Name: " << file.file_name << ", Type: " << file.file_type << ", Size: " << file.file_size << "MB";
-        return os;
-    }
-};
-
-class FileSystem {
-    File* root;
-
-private:
-
-    void insert(File*& root, const std::string& file_name, const std::string& file_type, int file_size) {
-        if (root == nullptr) root = new File(file_name, file_type, file_size);
-        else if (file_name < root->file_name) insert(root->left, file_name, file_type, file_size);
-        else if (file_name > root->file_name) insert(root->right, file_name, file_type, file_size);
-        else std::cout << "File already exists!" << std::endl; // Duplicate insertion
-    }
-
-    void delete_file(File*& root, const std::string& file_name) {
-        if (root == nullptr) return;
-
-        auto delete_and_assign = [&](File*& node, File*& to_assign)
-            {
-                File* temp = node;
-                node = to_assign;
-                delete temp;
-            };
-
-        if (file_name < root->file_name) delete_file(root->left, file_name);
-        else if (file_name > root->file_name) delete_file(root->right, file_name);
-        else {
-            // File found
-            if (!root->left && !root->right) {
-                delete root;
-                root = nullptr;
-            }
-            else if (root->left == nullptr) delete_and_assign(root, root->right);
-            else if (root->right == nullptr) delete_and_assign(root, root->left);
-            else {
-                File* minNode = root->right;
-                while (minNode->left != nullptr) minNode = minNode->left;
-
-                // Copy successor data to current node
-                root->file_name = minNode->file_name;
-                root->file_type = minNode->file_type;
-                root->file_size = minNode->file_size;
-                delete_file(root->right, minNode->file_name);
-            }
-        }
-    }
-
-    File* search(File* root, const std::string& file_name) {
-        if (root == nullptr || root->file_name == file_name) return root;
-        if (file_name < root->file_name) return search(root->left, file_name);
-        return search(root->right, file_name);
-    }
-
-    // Preorder traversal to search for files by size
-    void search_by_size(File* root, int threshold, std::vector<File*>& result) {
-        if (root == nullptr) return;
-        if (root->file_size > threshold) result.push_back(root);
-        search_by_size(root->left, threshold, result);
-        search_by_size(root->right, threshold, result);
-    }
-
-    void inorder(File* root, std::vector<File*>& result) {
-        if (root == nullptr) return;
-        inorder(root->left, result);
-        result.push_back(root);
-        inorder(root->right, result);
-    }
-
-    void preorder(File* root, std::vector<File*>& result) {
-        if (root == nullptr) return;
-        result.push_back(root);
-        preorder(root->left, result);
-        preorder(root->right, result);
-    }
-
-    void postorder(File* root, std::vector<File*>& result) {
-        if (root == nullptr) return;
-        postorder(root->left, result);
-        postorder(root->right, result);
-        result.push_back(root);
-    }
-
-    void clear(File*& root) {
-        if (root == nullptr) return;
-        clear(root->left);
-        clear(root->right);
-        delete root;
-        root = nullptr;
-    }
-
-
-public:
-    FileSystem() : root(nullptr) {}
-
-    ~FileSystem() { clear(root); }
-
-    void insert(const std::string& file_name, const std::string& file_type, int file_size) {
-        insert(root, file_name, file_type, file_size);
-    }
-
-    void delete_file(const std::string& file_name) { delete_file(root, file_name); }
-
-    void rename_file(const std::string& old_name, const std::string& new_name) {
-        File* file = search(root, old_name);
-        File* new_name_exists = search(root, new_name);
-
-        if (!file) return; // File not found
-        if (new_name_exists) return; // New name already exists
-
-        insert(new_name, file->file_type, file->file_size);
-        delete_file(old_name);
-    }
-
-    File* search(const std::string& file_name) { return search(root, file_name); }
-
-    std::vector<File*> search_by_size(int threshold) {
-        std::vector<File*> result;
-        search_by_size(root, threshold, result);
-        return result;
-    }
-
-    std::vector<File*> inorder() {
-        std::vector<File*> result;
-        inorder(root, result);
-        return result;
-    }
-
-    std::vector<File*> preorder() {
-        std::vector<File*> result;
-        preorder(root, result);
-        return result;
-    }
-
-    std::vector<File*> postorder() {
-        std::vector<File*> result;
-        postorder(root, result);
-        return result;
-    }
-};
 
 void print(std::vector<File*>& files) {
     for (const auto& file : files) std::cout << *file << std::endl;
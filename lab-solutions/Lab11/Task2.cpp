@@ -74,14 +74,16 @@
 #include <random>
 #include <iomanip>
 #include <set>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <atomic>
 
-// Function to count the number of inversions in an array
-int countInversions(const std::vector<int>& arr) {
-    int inversionCount = 0;
-    for (size_t i = 0; i < arr.size(); ++i)
-        for (size_t j = i + 1; j < arr.size(); ++j)
-            if (arr[i] > arr[j]) ++inversionCount;
-    return inversionCount;
+#include "inversions.hpp"
+
+// Function to count the number of inversions in an array, O(n log n) (see inversions.hpp)
+long long countInversions(const std::vector<int>& arr) {
+    return countInversionsParallel(arr);
 }
 
 // Abstract base class for sorting strategies
@@ -200,86 +202,353 @@ public:
 };
 
 
+// ------------------------------ Budget-aware strategies ------------------------------ //
+// The strategies below try to remove as many inversions as possible per operation spent.
+// Every element exchange is a single counted swap, so the array is always a permutation of
+// the input when the budget runs out, whatever step was interrupted.
+
+// Bottom-up merge sort: passes of width 1, 2, 4, ... A merge is started only if the remaining
+// budget covers its worst case (len - 1 comparisons + len writes), so it is never cut short.
+class BottomUpMergeSort : public SortingStrategy {
+public:
+    std::string name() override { return "Bottom-Up Merge"; }
+
+    void partialSort(std::vector<int>& arr, int K, int& comparisons, int& swaps) override {
+        int n = arr.size();
+        comparisons = 0;
+        swaps = 0;
+        std::vector<int> buffer(n);
+
+        for (int width = 1; width < n; width *= 2) {
+            for (int lo = 0; lo + width < n; lo += 2 * width) {
+                int mid = lo + width, hi = std::min(n, lo + 2 * width);
+                int len = hi - lo;
+                if (comparisons + swaps + 2 * len - 1 > K) return;
+
+                int i = lo, j = mid, k = lo;
+                while (i < mid && j < hi) {
+                    ++comparisons;
+                    buffer[k++] = (arr[j] < arr[i]) ? arr[j++] : arr[i++];
+                }
+                while (i < mid) buffer[k++] = arr[i++];
+                while (j < hi) buffer[k++] = arr[j++];
+                for (int m = lo; m < hi; ++m) arr[m] = buffer[m];
+                swaps += len;
+            }
+        }
+    }
+};
+
+// Heap-based top-k prefix: a min-heap is laid out mirrored (root at the last index), so every
+// extraction drops the next smallest element right after the sorted prefix arr[0, t).
+class HeapTopK : public SortingStrategy {
+    int n = 0;
+    int K = 0;
+    int* comparisons = nullptr;
+    int* swaps = nullptr;
+
+    bool exhausted() const { return *comparisons + *swaps >= K; }
+
+    // Heap index h (0 = root) lives at arr[n - 1 - h]; the heap holds indices [0, size)
+    bool siftDown(std::vector<int>& arr, int h, int size) {
+        auto at = [&](int index) -> int& { return arr[n - 1 - index]; };
+        while (2 * h + 1 < size) {
+            int child = 2 * h + 1;
+            if (child + 1 < size) {
+                if (exhausted()) return false;
+                ++*comparisons;
+                if (at(child + 1) < at(child)) ++child;
+            }
+            if (exhausted()) return false;
+            ++*comparisons;
+            if (!(at(child) < at(h))) break;
+            if (exhausted()) return false;
+            std::swap(at(h), at(child));
+            ++*swaps;
+            h = child;
+        }
+        return true;
+    }
+
+public:
+    std::string name() override { return "Heap Top-K"; }
+
+    void partialSort(std::vector<int>& arr, int K, int& comparisons, int& swaps) override {
+        this->n = arr.size();
+        this->K = K;
+        this->comparisons = &comparisons;
+        this->swaps = &swaps;
+        comparisons = 0;
+        swaps = 0;
+
+        for (int h = n / 2 - 1; h >= 0; --h)
+            if (!siftDown(arr, h, n)) return;
+
+        for (int size = n; size > 1; --size) {
+            // Move the minimum (root, arr[n - 1]) to the end of the heap, arr[n - size]
+            if (exhausted()) return;
+            std::swap(arr[n - 1], arr[n - size]);
+            ++swaps;
+            if (!siftDown(arr, 0, size - 1)) return;
+        }
+    }
+};
+
+// Introselect-style partitioning: ranges are partitioned breadth first around a median of
+// three, so the coarse order of the whole array improves before any range is finished. Short
+// ranges, and ranges past the depth limit, are finished with insertion sort.
+class IntroSelect : public SortingStrategy {
+public:
+    std::string name() override { return "Introselect"; }
+
+    void partialSort(std::vector<int>& arr, int K, int& comparisons, int& swaps) override {
+        int n = arr.size();
+        comparisons = 0;
+        swaps = 0;
+        auto exhausted = [&]() { return comparisons + swaps >= K; };
+        auto less = [&](int a, int b) { ++comparisons; return arr[a] < arr[b]; };
+        auto exchange = [&](int a, int b) { if (a != b) { std::swap(arr[a], arr[b]); ++swaps; } };
+
+        int depth_limit = 2;
+        for (int m = n; m > 1; m /= 2) depth_limit += 2;
+
+        struct Range { int lo, hi, depth; }; // [lo, hi)
+        std::vector<Range> level{ { 0, n, 0 } }, next;
+        while (!level.empty()) {
+            next.clear();
+            for (const Range& r : level) {
+                if (r.hi - r.lo <= 16 || r.depth >= depth_limit) {
+                    for (int i = r.lo + 1; i < r.hi; ++i) {
+                        for (int j = i; j > r.lo; --j) {
+                            if (exhausted()) return;
+                            if (!less(j, j - 1)) break;
+                            if (exhausted()) return;
+                            exchange(j, j - 1);
+                        }
+                    }
+                    continue;
+                }
+
+                // Median of three to arr[lo], then Hoare partition
+                int lo = r.lo, mid = r.lo + (r.hi - r.lo) / 2, hi = r.hi - 1;
+                if (comparisons + swaps + 6 > K) return;
+                if (less(mid, lo)) exchange(mid, lo);
+                if (less(hi, lo)) exchange(hi, lo);
+                if (less(hi, mid)) exchange(hi, mid);
+                exchange(lo, mid);
+
+                int i = lo, j = r.hi;
+                while (true) {
+                    do { if (exhausted()) return; } while (++i < r.hi - 1 && less(i, lo));
+                    do { if (exhausted()) return; } while (less(lo, --j));
+                    if (i >= j) break;
+                    if (exhausted()) return;
+                    exchange(i, j);
+                }
+                if (exhausted()) return;
+                exchange(lo, j);
+                next.push_back({ r.lo, j, r.depth + 1 });
+                next.push_back({ j + 1, r.hi, r.depth + 1 });
+            }
+            level.swap(next);
+        }
+    }
+};
+
+// Shell sort over an arbitrary gap sequence (largest gap first), using exchanges
+class GappedShellSort : public SortingStrategy {
+    std::string strategy_name;
+    std::vector<int> (*make_gaps)(int n);
+
+public:
+    GappedShellSort(std::string name, std::vector<int>(*make_gaps)(int n)) : strategy_name(name), make_gaps(make_gaps) {}
+
+    std::string name() override { return strategy_name; }
+
+    // Ciura's empirically best gaps, extended geometrically by 2.25
+    static std::vector<int> ciuraGaps(int n) {
+        std::vector<int> gaps = { 1, 4, 10, 23, 57, 132, 301, 701 };
+        while (gaps.back() < n) gaps.push_back(static_cast<int>(gaps.back() * 2.25));
+        while (gaps.size() > 1 && gaps.back() >= n) gaps.pop_back();
+        std::reverse(gaps.begin(), gaps.end());
+        return gaps;
+    }
+
+    // Tokuda: h_k = ceil((9^k - 4^k) / (5 * 4^(k - 1))), i.e. h_k = ceil(h'_k) with h'_k = 2.25 h'_(k-1) + 1
+    static std::vector<int> tokudaGaps(int n) {
+        std::vector<int> gaps;
+        double h = 1.0;
+        while (static_cast<int>(std::ceil(h)) < n || gaps.empty()) {
+            gaps.push_back(static_cast<int>(std::ceil(h)));
+            h = 2.25 * h + 1.0;
+        }
+        std::reverse(gaps.begin(), gaps.end());
+        return gaps;
+    }
+
+    void partialSort(std::vector<int>& arr, int K, int& comparisons, int& swaps) override {
+        int n = arr.size();
+        comparisons = 0;
+        swaps = 0;
+
+        for (int gap : make_gaps(n)) {
+            for (int i = gap; i < n; ++i) {
+                for (int j = i; j >= gap; j -= gap) {
+                    if (comparisons + swaps >= K) return;
+                    ++comparisons;
+                    if (!(arr[j] < arr[j - gap])) break;
+                    if (comparisons + swaps >= K) return;
+                    std::swap(arr[j], arr[j - gap]);
+                    ++swaps;
+                }
+            }
+        }
+    }
+};
+
+
+// One fresh instance of every strategy; each Evaluator worker thread owns its own set
+std::vector<std::unique_ptr<SortingStrategy>> makeStrategies() {
+    std::vector<std::unique_ptr<SortingStrategy>> strategies;
+    strategies.push_back(std::make_unique<InsertionSort>());
+    strategies.push_back(std::make_unique<SelectionSort>());
+    strategies.push_back(std::make_unique<ShellSort>());
+    strategies.push_back(std::make_unique<BottomUpMergeSort>());
+    strategies.push_back(std::make_unique<HeapTopK>());
+    strategies.push_back(std::make_unique<IntroSelect>());
+    strategies.push_back(std::make_unique<GappedShellSort>("Shell (Ciura)", GappedShellSort::ciuraGaps));
+    strategies.push_back(std::make_unique<GappedShellSort>("Shell (Tokuda)", GappedShellSort::tokudaGaps));
+    return strategies;
+}
+
+
 class Evaluator {
     double compare_weight;
     double swap_weight;
     double remaining_inversion_weight;
+    unsigned long long seed; // Seeds the per-run RNG streams, same seed -> same results
+    unsigned threads;
 
-    double compute_cost(int comparisons, int swaps, int remaining_inversions) {
+    double compute_cost(int comparisons, int swaps, long long remaining_inversions) {
         return compare_weight * comparisons + swap_weight * swaps + remaining_inversion_weight * remaining_inversions;
     }
 
-    void print(std::string name, double cost, double comparisons, double swaps, double remaining_inversions) {
+    void print(std::string name, double cost, double comparisons, double swaps, double remaining_inversions, double removed_per_operation) {
         std::cout << std::left << std::setw(15) << name
             << " -> Operations used: " << std::right << std::setw(4) << (comparisons + swaps)
             << ", Comparisons: " << std::setw(4) << comparisons
             << ", Swaps: " << std::setw(4) << swaps
             << ", Remaining inversions: " << std::setw(5) << remaining_inversions
             << ", Cost: " << std::fixed << std::setprecision(2) << std::setw(6) << cost
+            << ", Inversions removed/op: " << std::setw(6) << removed_per_operation
             << '\n';
     }
 
 public:
 
-    Evaluator(double compare_weight, double swap_weight, double remaining_inversion_weight)
-        : compare_weight(compare_weight), swap_weight(swap_weight), remaining_inversion_weight(remaining_inversion_weight) {
+    Evaluator(double compare_weight, double swap_weight, double remaining_inversion_weight,
+        unsigned long long seed = std::random_device{}(), unsigned threads = std::thread::hardware_concurrency())
+        : compare_weight(compare_weight), swap_weight(swap_weight), remaining_inversion_weight(remaining_inversion_weight),
+        seed(seed), threads(std::max(1u, threads)) {
     }
 
     template<typename SortAlgorithm>
     double evaluate(SortAlgorithm& algorithm, std::vector<int> arr, int K) {
         int comparisons = 0, swaps = 0;
         algorithm.partialSort(arr, K, comparisons, swaps);
-        int remaining_inversions = countInversions(arr);
+        long long remaining_inversions = countInversions(arr);
         return compute_cost(comparisons, swaps, remaining_inversions);
     }
 
-    // Perform runs number of runs on random arrays, and average cost accross all runs
-    std::vector<std::string> evaluate_strategies(int K, int runs) {
-        std::vector<double> costs(3); // Store costs for each strategy
-        std::vector<double> total_compares(3); // Store comparisons for each strategy
-        std::vector<double> total_swaps(3); // Store swaps for each strategy
-        std::vector<double> total_remaining_inversions(3); // Store remaining inversions for each strategy
-        std::vector<SortingStrategy*> strategies = { new InsertionSort(), new SelectionSort(), new ShellSort() };
-
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<int> dist(1, 1000); // Random numbers between 1 and 1000
-
-        for (int i = 0; i < runs; ++i) {
-            // Generate a random array of size 100
-            std::vector<int> arr(100);
-            std::generate(arr.begin(), arr.end(), [&]() { return dist(gen); });
-
-            for (int j = 0; j < strategies.size(); ++j) {
-                int comparisons = 0, swaps = 0;
-                strategies[j]->partialSort(arr, K, comparisons, swaps);
-                int remaining_inversions = countInversions(arr);
-                double cost = compute_cost(comparisons, swaps, remaining_inversions);
-                costs[j] += cost;
-                total_compares[j] += static_cast<double>(comparisons);
-                total_swaps[j] += static_cast<double>(swaps);
-                total_remaining_inversions[j] += static_cast<double>(remaining_inversions);
+    // Perform runs number of runs on random arrays, and average cost accross all runs.
+    //
+    // Runs are spread over worker threads. Every worker owns its strategy instances and its
+    // totals, and every run draws its array from its own RNG stream seeded with (seed, run), so
+    // the results for a given seed do not depend on the thread count. Totals are integers and
+    // are summed after the workers join, so the reduction needs no locks and is exact.
+    std::vector<std::string> evaluate_strategies(int K, int runs, size_t array_size = 100) {
+        const size_t strategy_count = makeStrategies().size();
+        const unsigned workers = static_cast<unsigned>(std::max(1, std::min<int>(threads, runs)));
+        // Spare cores go to the inversion counter when there are fewer runs than threads
+        const unsigned inversion_threads = std::max(1u, threads / workers);
+
+        struct Totals {
+            std::vector<unsigned long long> comparisons, swaps, remaining_inversions;
+            unsigned long long initial_inversions = 0;
+            explicit Totals(size_t n) : comparisons(n), swaps(n), remaining_inversions(n) {}
+        };
+        std::vector<Totals> totals(workers, Totals(strategy_count));
+        std::atomic<int> next_run{ 0 };
+        const int batch = 16; // Runs claimed per fetch_add
+
+        auto worker = [&](unsigned w) {
+            std::vector<std::unique_ptr<SortingStrategy>> strategies = makeStrategies();
+            std::uniform_int_distribution<int> dist(1, 1000); // Random numbers between 1 and 1000
+            std::vector<int> original(array_size), arr(array_size);
+            Totals& local = totals[w];
+
+            for (int first = next_run.fetch_add(batch); first < runs; first = next_run.fetch_add(batch)) {
+                for (int i = first; i < std::min(runs, first + batch); ++i) {
+                    std::seed_seq seq{ static_cast<unsigned>(seed), static_cast<unsigned>(seed >> 32), static_cast<unsigned>(i) };
+                    std::mt19937 gen(seq);
+                    std::generate(original.begin(), original.end(), [&]() { return dist(gen); });
+                    local.initial_inversions += countInversionsParallel(original, inversion_threads);
+
+                    for (size_t j = 0; j < strategies.size(); ++j) {
+                        arr = original; // Every strategy starts from the same unsorted array
+                        int comparisons = 0, swaps = 0;
+                        strategies[j]->partialSort(arr, K, comparisons, swaps);
+                        local.comparisons[j] += comparisons;
+                        local.swaps[j] += swaps;
+                        local.remaining_inversions[j] += countInversionsParallel(arr, inversion_threads);
+                    }
+                }
+            }
+            };
+
+        std::vector<std::thread> pool;
+        for (unsigned w = 0; w < workers; ++w) pool.emplace_back(worker, w);
+        for (auto& t : pool) t.join();
+
+        // Reduce, then average the costs, comparisons, swaps and remaining inversions
+        Totals sum(strategy_count);
+        for (const Totals& local : totals) {
+            sum.initial_inversions += local.initial_inversions;
+            for (size_t j = 0; j < strategy_count; ++j) {
+                sum.comparisons[j] += local.comparisons[j];
+                sum.swaps[j] += local.swaps[j];
+                sum.remaining_inversions[j] += local.remaining_inversions[j];
             }
         }
 
-        // Average the costs, comparisons, and swaps
-        for (int j = 0; j < costs.size(); ++j) {
-            costs[j] /= runs;
-            total_compares[j] /= runs;
-            total_swaps[j] /= runs;
-            total_remaining_inversions[j] /= runs;
+        std::vector<std::unique_ptr<SortingStrategy>> strategies = makeStrategies();
+        std::vector<double> costs(strategy_count), average_compares(strategy_count), average_swaps(strategy_count),
+            average_remaining_inversions(strategy_count), removed_per_operation(strategy_count);
+        for (size_t j = 0; j < strategy_count; ++j) {
+            average_compares[j] = static_cast<double>(sum.comparisons[j]) / runs;
+            average_swaps[j] = static_cast<double>(sum.swaps[j]) / runs;
+            average_remaining_inversions[j] = static_cast<double>(sum.remaining_inversions[j]) / runs;
+            // The cost is linear, so the cost of the averages is the average cost
+            costs[j] = compare_weight * average_compares[j] + swap_weight * average_swaps[j]
+                + remaining_inversion_weight * average_remaining_inversions[j];
+
+            // Efficiency under the budget: how much closer to sorted each operation got the array
+            unsigned long long operations = sum.comparisons[j] + sum.swaps[j];
+            double removed = static_cast<double>(sum.initial_inversions) - static_cast<double>(sum.remaining_inversions[j]);
+            removed_per_operation[j] = operations ? removed / operations : 0.0;
         }
 
         // Print the average costs, comparisons, and swaps for each strategy, use iomanip to format the output
         std::cout << "Average Costs, Comparisons, and Swaps for each strategy:\n";
-        for (int j = 0; j < strategies.size(); ++j) {
-            print(strategies[j]->name(), costs[j], total_compares[j], total_swaps[j], total_remaining_inversions[j]);
+        for (size_t j = 0; j < strategy_count; ++j) {
+            print(strategies[j]->name(), costs[j], average_compares[j], average_swaps[j], average_remaining_inversions[j],
+                removed_per_operation[j]);
         }
 
         // Find the best strategy/strategies based on the lowest cost or lowest remaining inversions
         double lowest_cost = std::numeric_limits<double>::max();
         std::vector<std::string> best_strategies;
-        for (int j = 0; j < costs.size(); ++j) {
+        for (size_t j = 0; j < strategy_count; ++j) {
             if (costs[j] < lowest_cost) {
                 lowest_cost = costs[j];
                 best_strategies = { strategies[j]->name() };
@@ -287,8 +556,6 @@ public:
             else if (costs[j] == lowest_cost) best_strategies.push_back(strategies[j]->name());
         }
 
-        // Delete the strategy objects
-        for (auto strategy : strategies) delete strategy;
         return best_strategies;
     }
 };
@@ -336,11 +603,15 @@ int main() {
     std::cout << "Operation Limit: " << operation_limit << std::endl;
     std::cout << "Compare Weight: " << compare_weight << std::endl;
     std::cout << "Swap Weight: " << swap_weight << std::endl;
-    std::cout << "Remaining Inversion Weight: " << remaining_inversion_weight << "\n\n";
+    std::cout << "Remaining Inversion Weight: " << remaining_inversion_weight << std::endl;
+
+    // Print the seed so that a run can be reproduced, on any number of threads
+    unsigned long long seed = std::random_device{}();
+    std::cout << "Seed: " << seed << "\n\n";
 
 
     // Evaluate the strategies with the defined operation limit and weights
-    Evaluator evaluator(compare_weight, swap_weight, remaining_inversion_weight);
+    Evaluator evaluator(compare_weight, swap_weight, remaining_inversion_weight, seed);
     std::vector<std::string> best_strategies = evaluator.evaluate_strategies(operation_limit, 10); // 10 runs for averaging
 
 
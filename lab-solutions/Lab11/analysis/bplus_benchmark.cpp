@@ -0,0 +1,91 @@
+// Compares the AVL FileSystem with BPlusFileSystem on the same set of directory-style names:
+// building (n inserts, and bulk_load for the B+-tree), random lookups, a full in-order scan,
+// a range scan and search_by_size.
+//
+// Usage: bplus_benchmark [number of files]
+
+#include<iostream>
+#include<iomanip>
+#include<random>
+#include<string>
+#include<vector>
+#include<algorithm>
+
+#include "../file_system.hpp"
+#include "../bplus_file_system.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+template <typename Function>
+double time_ms(Function function) {
+    Stopwatch stopwatch;
+    stopwatch.start();
+    function();
+    stopwatch.stop();
+    return stopwatch.get_elapsed_time_milliseconds();
+}
+
+void print_row(const std::string& operation, double avl_ms, double bplus_ms) {
+    std::cout << std::left << std::setw(24) << operation << std::right << std::fixed << std::setprecision(2)
+        << std::setw(14) << avl_ms << std::setw(14) << bplus_ms
+        << std::setw(10) << (bplus_ms > 0 ? avl_ms / bplus_ms : 0.0) << "x" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t n = argc > 1 ? std::stoul(argv[1]) : 500000;
+
+    std::mt19937 rng(42);
+    std::vector<FileInfo> files(n);
+    for (size_t i = 0; i < n; ++i) {
+        files[i].file_name = "home/user/projects/p" + std::to_string(i % 97) + "/src/file" + std::to_string(i) + ".txt";
+        files[i].file_type = "txt";
+        files[i].file_size = static_cast<int>(rng() % 1000);
+    }
+    std::vector<FileInfo> shuffled = files;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+    std::sort(files.begin(), files.end(), [](const FileInfo& a, const FileInfo& b) { return a.file_name < b.file_name; });
+
+    std::vector<std::string> queries(n);
+    for (size_t i = 0; i < n; ++i) queries[i] = files[rng() % n].file_name;
+
+    FileSystem avl;
+    BPlusFileSystem bplus;
+    std::cout << "Files: " << n << std::endl;
+    std::cout << std::left << std::setw(24) << "Operation" << std::right
+        << std::setw(14) << "AVL (ms)" << std::setw(14) << "B+ (ms)" << std::setw(11) << "Speedup" << std::endl;
+
+    print_row("insert (random order)",
+        time_ms([&]() { for (const auto& f : shuffled) avl.insert(f.file_name, f.file_type, f.file_size); }),
+        time_ms([&]() { for (const auto& f : shuffled) bplus.insert(f.file_name, f.file_type, f.file_size); }));
+
+    BPlusFileSystem loaded;
+    std::cout << std::left << std::setw(24) << "bulk_load (sorted)" << std::right << std::setw(14) << "-"
+        << std::setw(14) << time_ms([&]() { loaded.bulk_load(files); }) << std::endl;
+
+    size_t found = 0;
+    print_row("search",
+        time_ms([&]() { for (const auto& q : queries) found += avl.search(q) != nullptr; }),
+        time_ms([&]() { for (const auto& q : queries) found += bplus.search(q).has_value(); }));
+
+    size_t bytes = 0;
+    print_row("full in-order scan",
+        time_ms([&]() { for (File* f : avl.inorder()) bytes += f->file_name.size(); }),
+        time_ms([&]() { bplus.for_each([&](std::string_view name, std::string_view, int) { bytes += name.size(); }); }));
+
+    // Every name under p1..p4, about 4% of the files
+    const std::string first = "home/user/projects/p1/", last = "home/user/projects/p4~";
+    print_row("range scan p1..p4",
+        time_ms([&]() {
+            for (File* f : avl.inorder())
+                if (f->file_name >= first && f->file_name <= last) bytes += f->file_name.size();
+            }),
+        time_ms([&]() { bplus.range(first, last, [&](std::string_view name, std::string_view, int) { bytes += name.size(); }); }));
+
+    print_row("search_by_size > 990",
+        time_ms([&]() { found += avl.search_by_size(990).size(); }),
+        time_ms([&]() { found += bplus.search_by_size(990).size(); }));
+
+    std::cout << std::endl << "AVL height: " << avl.height() << ", B+ height: " << bplus.height()
+        << " (bulk loaded: " << loaded.height() << ")" << std::endl;
+    std::cout << "Checksum: " << found + bytes << std::endl;
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Read throughput of ConcurrentFileSystem while a writer keeps renaming files, against the
+// plain FileSystem behind a std::shared_mutex. Readers mix search (98%) and search_by_size
+// with a high threshold (2%); the writer renames files back and forth without pause.
+//
+// Usage: concurrency_benchmark [number of files] [seconds per run]
+
+#include<iostream>
+#include<iomanip>
+#include<random>
+#include<string>
+#include<vector>
+#include<thread>
+#include<atomic>
+#include<shared_mutex>
+#include<chrono>
+
+#include "../file_system.hpp"
+#include "../concurrent_file_system.hpp"
+
+// The baseline: readers share a lock that every rename takes exclusively
+class LockedFileSystem {
+    FileSystem files;
+    std::shared_mutex mutex;
+
+public:
+    void insert(const std::string& name, const std::string& type, int size) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        files.insert(name, type, size);
+    }
+
+    void rename_file(const std::string& old_name, const std::string& new_name) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        files.rename_file(old_name, new_name);
+    }
+
+    bool search(const std::string& name) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return files.search(name) != nullptr;
+    }
+
+    size_t search_by_size(int threshold) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return files.search_by_size(threshold).size();
+    }
+};
+
+std::string file_name(size_t i) { return "dir" + std::to_string(i % 32) + "/file" + std::to_string(i) + ".txt"; }
+
+bool found(bool result) { return result; }
+bool found(const std::optional<FileInfo>& result) { return result.has_value(); }
+size_t matches(size_t count) { return count; }
+size_t matches(const std::vector<FileInfo>& files) { return files.size(); }
+
+// Runs readers reader threads and one renaming writer for the given time; returns reads/sec
+template <typename Catalog>
+double run(Catalog& catalog, size_t n, unsigned readers, double seconds, size_t& renames) {
+    std::atomic<bool> stop{ false };
+    std::atomic<size_t> total_reads{ 0 }, checksum{ 0 };
+    std::vector<std::thread> pool;
+    for (unsigned r = 0; r < readers; ++r) {
+        pool.emplace_back([&, r]() {
+            std::mt19937 rng(r + 1);
+            size_t reads = 0, hits = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (rng() % 50 == 0) hits += matches(catalog.search_by_size(995));
+                else hits += found(catalog.search(file_name(rng() % n)));
+                ++reads;
+            }
+            total_reads += reads;
+            checksum += hits;
+            });
+    }
+    std::thread writer([&]() {
+        std::mt19937 rng(12345);
+        size_t count = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::string name = file_name(rng() % n);
+            catalog.rename_file(name, name + ".tmp");
+            catalog.rename_file(name + ".tmp", name);
+            count += 2;
+        }
+        renames = count;
+        });
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    writer.join();
+    for (auto& t : pool) t.join();
+    return total_reads / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t n = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const double seconds = argc > 2 ? std::stod(argv[2]) : 1.0;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::mt19937 rng(42);
+    ConcurrentFileSystem concurrent;
+    LockedFileSystem locked;
+    for (size_t i = 0; i < n; ++i) {
+        int size = static_cast<int>(rng() % 1000);
+        concurrent.insert(file_name(i), "txt", size);
+        locked.insert(file_name(i), "txt", size);
+    }
+
+    std::cout << "Files: " << n << ", cores: " << cores << ", one writer renaming continuously" << std::endl;
+    std::cout << std::left << std::setw(10) << "Readers" << std::right
+        << std::setw(20) << "Lock-free reads/s" << std::setw(14) << "renames/s"
+        << std::setw(24) << "shared_mutex reads/s" << std::setw(14) << "renames/s" << std::endl;
+    for (unsigned readers = 1; readers <= 2 * cores; readers *= 2) {
+        size_t concurrent_renames = 0, locked_renames = 0;
+        double concurrent_reads = run(concurrent, n, readers, seconds, concurrent_renames);
+        double locked_reads = run(locked, n, readers, seconds, locked_renames);
+        std::cout << std::left << std::setw(10) << readers << std::right << std::fixed << std::setprecision(0)
+            << std::setw(20) << concurrent_reads << std::setw(14) << concurrent_renames / seconds
+            << std::setw(24) << locked_reads << std::setw(14) << locked_renames / seconds << std::endl;
+    }
+    return 0;
+}
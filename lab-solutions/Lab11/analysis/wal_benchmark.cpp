@@ -0,0 +1,77 @@
+// Measures PersistentFileSystem throughput for different group commit sizes (operations per
+// fsync), then the cost of recovery: replaying a full log versus mapping a snapshot and
+// replaying only the records after it.
+//
+// Usage: wal_benchmark [operations] [directory]
+
+#include<iostream>
+#include<iomanip>
+#include<random>
+#include<string>
+#include<vector>
+#include<filesystem>
+
+#include "../persistent_file_system.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+std::string file_name(const std::string& prefix, size_t i) {
+    return prefix + "dir" + std::to_string(i % 64) + "/file" + std::to_string(i) + ".txt";
+}
+
+// Inserts operations files, deleting and renaming some of them along the way
+void run_workload(PersistentFileSystem& fs, size_t operations, unsigned seed, const std::string& prefix = "") {
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < operations; ++i) {
+        std::string name = file_name(prefix, i);
+        fs.insert(name, "txt", static_cast<int>(rng() % 1000));
+        if (i % 10 == 9) fs.delete_file(file_name(prefix, i - 3));
+        if (i % 10 == 4) fs.rename_file(name, name + ".bak");
+    }
+    fs.commit();
+}
+
+int main(int argc, char* argv[]) {
+    const size_t operations = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const std::filesystem::path root = argc > 2 ? argv[2] : std::filesystem::temp_directory_path() / "wal_benchmark";
+
+    std::cout << "Group commit (" << operations << " inserts plus deletes and renames)" << std::endl;
+    std::cout << std::left << std::setw(14) << "Ops/fsync" << std::right << std::setw(14) << "Seconds" << std::setw(16) << "Ops/sec" << std::endl;
+    for (size_t group : { 1, 8, 64, 512, 4096 }) {
+        std::filesystem::remove_all(root);
+        // Without periodic snapshots, so that only logging and fsync are measured
+        PersistentFileSystem fs(root, group, static_cast<size_t>(-1));
+        // fsync per operation is slow on most disks, so time fewer operations there
+        size_t count = group == 1 ? std::min<size_t>(operations, 2000) : operations;
+        Stopwatch stopwatch;
+        stopwatch.start();
+        run_workload(fs, count, 1);
+        stopwatch.stop();
+        double seconds = stopwatch.get_elapsed_time_seconds();
+        size_t logged = fs.last_lsn();
+        std::cout << std::left << std::setw(14) << group << std::right << std::fixed << std::setprecision(3)
+            << std::setw(14) << seconds << std::setw(16) << std::setprecision(0) << logged / seconds << std::endl;
+    }
+
+    std::cout << std::endl << "Recovery" << std::endl;
+    std::filesystem::remove_all(root);
+    {
+        PersistentFileSystem fs(root, 4096, static_cast<size_t>(-1));
+        run_workload(fs, operations, 2);
+    }
+    {
+        PersistentFileSystem fs(root);
+        const auto& stats = fs.recovery_stats();
+        std::cout << "Full log replay:      " << std::fixed << std::setprecision(2) << stats.seconds * 1e3 << " ms ("
+            << stats.replayed_records << " records, " << fs.size() << " files)" << std::endl;
+        fs.snapshot();
+        run_workload(fs, operations / 100, 3, "tail/"); // A short tail after the snapshot
+    }
+    {
+        PersistentFileSystem fs(root);
+        const auto& stats = fs.recovery_stats();
+        std::cout << "Snapshot + tail:      " << std::fixed << std::setprecision(2) << stats.seconds * 1e3 << " ms ("
+            << stats.snapshot_files << " files from the snapshot, " << stats.replayed_records << " records replayed)" << std::endl;
+    }
+    std::filesystem::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,494 @@
+#ifndef BPLUS_FILE_SYSTEM_HPP
+#define BPLUS_FILE_SYSTEM_HPP
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <type_traits>
+
+#include "file.hpp"
+
+
+namespace bplus_detail {
+
+    // Visitors get (name, type, size) and either return nothing or false to stop the scan
+    template <typename Visitor>
+    bool visit(Visitor& visitor, std::string_view name, std::string_view type, int size) {
+        if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::string_view, std::string_view, int>>) {
+            visitor(name, type, size);
+            return true;
+        }
+        else return static_cast<bool>(visitor(name, type, size));
+    }
+
+    // Up to Capacity strings packed back to back in one buffer, ends[i] is where string i ends
+    template <size_t Capacity>
+    struct StringColumn {
+        std::string bytes;
+        std::uint32_t ends[Capacity];
+        size_t count = 0;
+
+        size_t begin_of(size_t i) const { return i ? ends[i - 1] : 0; }
+
+        std::string_view view(size_t i) const {
+            size_t begin = begin_of(i);
+            return std::string_view(bytes.data() + begin, ends[i] - begin);
+        }
+
+        void insert(size_t i, std::string_view s) {
+            size_t begin = begin_of(i);
+            bytes.insert(begin, s.data(), s.size());
+            for (size_t j = count; j > i; --j) ends[j] = ends[j - 1] + static_cast<std::uint32_t>(s.size());
+            ends[i] = static_cast<std::uint32_t>(begin + s.size());
+            ++count;
+        }
+
+        void push_back(std::string_view s) {
+            bytes.append(s.data(), s.size());
+            ends[count++] = static_cast<std::uint32_t>(bytes.size());
+        }
+
+        void erase(size_t i) {
+            size_t begin = begin_of(i), length = ends[i] - begin;
+            bytes.erase(begin, length);
+            for (size_t j = i; j + 1 < count; ++j) ends[j] = ends[j + 1] - static_cast<std::uint32_t>(length);
+            --count;
+        }
+
+        void clear() {
+            bytes.clear();
+            count = 0;
+        }
+    };
+
+    // Sorted keys stored as one common prefix plus the remaining suffixes. Every key in a node
+    // shares the prefix of the node's first and last key, so long directory-style names
+    // ("project/src/file1.cpp", ...) cost a few bytes each and a node stays within a few cache
+    // lines. Lookups compare against the prefix once and binary search the short suffixes.
+    template <size_t Capacity>
+    struct KeyBlock {
+        std::string prefix;
+        StringColumn<Capacity> suffixes;
+
+        size_t size() const { return suffixes.count; }
+
+        void key(size_t i, std::string& out) const {
+            out.assign(prefix);
+            std::string_view suffix = suffixes.view(i);
+            out.append(suffix.data(), suffix.size());
+        }
+
+        std::string key(size_t i) const {
+            std::string out;
+            key(i, out);
+            return out;
+        }
+
+        // <0, 0 or >0 as key(i) is less than, equal to or greater than key
+        int compare(size_t i, std::string_view key) const {
+            int c = std::string_view(prefix).compare(key.substr(0, prefix.size()));
+            if (c != 0) return c;
+            return suffixes.view(i).compare(key.substr(prefix.size()));
+        }
+
+        // First index whose key is >= key (or > key when upper is set)
+        size_t bound(std::string_view key, bool upper) const {
+            int c = std::string_view(prefix).compare(key.substr(0, prefix.size()));
+            if (c < 0) return size(); // Every key is smaller
+            if (c > 0) return 0;      // Every key is larger
+            std::string_view rest = key.substr(prefix.size());
+            size_t lo = 0, hi = size();
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                int r = suffixes.view(mid).compare(rest);
+                if (r < 0 || (upper && r == 0)) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo;
+        }
+
+        size_t lower_bound(std::string_view key) const { return bound(key, false); }
+        size_t upper_bound(std::string_view key) const { return bound(key, true); }
+
+        void insert(size_t i, std::string_view key) {
+            if (size() == 0) {
+                prefix.assign(key.data(), key.size());
+                suffixes.push_back(std::string_view());
+                return;
+            }
+            size_t common = 0;
+            while (common < prefix.size() && common < key.size() && prefix[common] == key[common]) ++common;
+            if (common < prefix.size()) {
+                // The new key shortens the shared prefix: push the dropped part into every suffix
+                std::string_view tail = std::string_view(prefix).substr(common);
+                StringColumn<Capacity> widened;
+                for (size_t j = 0; j < size(); ++j) {
+                    std::string suffix(tail);
+                    suffix.append(suffixes.view(j));
+                    widened.push_back(suffix);
+                }
+                suffixes = std::move(widened);
+                prefix.resize(common);
+            }
+            suffixes.insert(i, key.substr(prefix.size()));
+        }
+
+        // Removing a key never invalidates the prefix, it is only possibly shorter than it could be
+        void erase(size_t i) { suffixes.erase(i); }
+
+        // Rebuilds the block from sorted keys[begin, end) with the longest common prefix
+        void assign(const std::vector<std::string>& keys, size_t begin, size_t end) {
+            suffixes.clear();
+            prefix.clear();
+            if (begin == end) return;
+            const std::string& first = keys[begin];
+            const std::string& last = keys[end - 1];
+            size_t common = 0;
+            while (common < first.size() && common < last.size() && first[common] == last[common]) ++common;
+            prefix.assign(first, 0, common);
+            for (size_t i = begin; i < end; ++i) suffixes.push_back(std::string_view(keys[i]).substr(common));
+        }
+
+        std::vector<std::string> keys() const {
+            std::vector<std::string> result(size());
+            for (size_t i = 0; i < size(); ++i) key(i, result[i]);
+            return result;
+        }
+    };
+}
+
+// B+-tree of files ordered by name, as an alternative to the pointer-per-file FileSystem.
+//
+// Inner nodes hold up to inner_capacity children and leaves up to leaf_capacity files. Keys are
+// prefix-compressed per node and a leaf stores its files column-wise (names, types and sizes in
+// separate arrays), so a lookup touches about log_64(n) nodes instead of log_2(n) scattered File
+// nodes, and scans read contiguous arrays. Leaves are linked left to right for range scans.
+//
+// Deletion is lazy: files are removed from their leaf, but underfull leaves are neither merged
+// nor redistributed. bulk_load rebuilds a compact tree from a sorted list in O(n).
+class BPlusFileSystem {
+public:
+    static constexpr size_t leaf_capacity = 64;
+    static constexpr size_t inner_capacity = 64;
+
+private:
+    struct Node {
+        bool leaf;
+        explicit Node(bool leaf) : leaf(leaf) {}
+    };
+
+    // One spare slot: a node is split right after it overflows
+    struct Leaf : Node {
+        bplus_detail::KeyBlock<leaf_capacity + 1> names;
+        bplus_detail::StringColumn<leaf_capacity + 1> types;
+        int sizes[leaf_capacity + 1];
+        Leaf* next = nullptr;
+
+        Leaf() : Node(true) {}
+        size_t size() const { return names.size(); }
+    };
+
+    // separators[i] is the smallest name in children[i + 1] when it was created
+    struct Inner : Node {
+        bplus_detail::KeyBlock<inner_capacity> separators;
+        Node* children[inner_capacity + 1];
+
+        Inner() : Node(false) {}
+        size_t child_count() const { return separators.size() + 1; }
+    };
+
+    Node* root;
+    size_t file_count;
+    int levels; // 1 when the root is a leaf
+
+    void clear() {
+        std::vector<Node*> stack;
+        if (root) stack.push_back(root);
+        while (!stack.empty()) {
+            Node* node = stack.back();
+            stack.pop_back();
+            if (node->leaf) delete static_cast<Leaf*>(node);
+            else {
+                Inner* inner = static_cast<Inner*>(node);
+                for (size_t i = 0; i < inner->child_count(); ++i) stack.push_back(inner->children[i]);
+                delete inner;
+            }
+        }
+        root = nullptr;
+        file_count = 0;
+        levels = 0;
+    }
+
+    // Descends to the leaf that would hold name, recording the inner nodes and child indices
+    Leaf* find_leaf(std::string_view name, std::vector<std::pair<Inner*, size_t>>* path = nullptr) const {
+        Node* node = root;
+        while (node && !node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            size_t child = inner->separators.upper_bound(name);
+            if (path) path->emplace_back(inner, child);
+            node = inner->children[child];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    Leaf* leftmost_leaf() const {
+        Node* node = root;
+        while (node && !node->leaf) node = static_cast<Inner*>(node)->children[0];
+        return static_cast<Leaf*>(node);
+    }
+
+    // Moves the upper half of an overflowing leaf into a new right sibling, returning it
+    static Leaf* split(Leaf* leaf, std::string& separator) {
+        const size_t n = leaf->size(), middle = n / 2;
+        std::vector<std::string> names = leaf->names.keys();
+        std::vector<std::string> types(n);
+        for (size_t i = 0; i < n; ++i) types[i].assign(leaf->types.view(i));
+
+        Leaf* right = new Leaf();
+        right->names.assign(names, middle, n);
+        for (size_t i = middle; i < n; ++i) {
+            right->types.push_back(types[i]);
+            right->sizes[i - middle] = leaf->sizes[i];
+        }
+        leaf->names.assign(names, 0, middle);
+        leaf->types.clear();
+        for (size_t i = 0; i < middle; ++i) leaf->types.push_back(types[i]);
+
+        right->next = leaf->next;
+        leaf->next = right;
+        separator = names[middle];
+        return right;
+    }
+
+    // Same for an inner node; the middle separator moves up into separator
+    static Inner* split(Inner* inner, std::string& separator) {
+        const size_t children = inner->child_count(), middle = children / 2;
+        std::vector<std::string> keys = inner->separators.keys();
+
+        Inner* right = new Inner();
+        right->separators.assign(keys, middle, keys.size());
+        for (size_t i = middle; i < children; ++i) right->children[i - middle] = inner->children[i];
+        inner->separators.assign(keys, 0, middle - 1);
+        separator = keys[middle - 1];
+        return right;
+    }
+
+    // Builds one level above nodes, whose smallest names are firsts, in groups of up to capacity
+    template <typename Make>
+    static std::vector<Node*> build_level(const std::vector<Node*>& nodes, std::vector<std::string>& firsts, Make make) {
+        const size_t groups = (nodes.size() + inner_capacity - 1) / inner_capacity;
+        std::vector<Node*> parents;
+        std::vector<std::string> parent_firsts;
+        for (size_t g = 0; g < groups; ++g) {
+            size_t begin = nodes.size() * g / groups, end = nodes.size() * (g + 1) / groups;
+            parents.push_back(make(nodes, firsts, begin, end));
+            parent_firsts.push_back(firsts[begin]);
+        }
+        firsts.swap(parent_firsts);
+        return parents;
+    }
+
+public:
+    BPlusFileSystem() : root(nullptr), file_count(0), levels(0) {}
+
+    ~BPlusFileSystem() { clear(); }
+
+    BPlusFileSystem(const BPlusFileSystem&) = delete;
+    BPlusFileSystem& operator=(const BPlusFileSystem&) = delete;
+
+    void insert(const std::string& file_name, const std::string& file_type, int file_size) {
+        if (!root) {
+            root = new Leaf();
+            levels = 1;
+        }
+        std::vector<std::pair<Inner*, size_t>> path;
+        Leaf* leaf = find_leaf(file_name, &path);
+        size_t position = leaf->names.lower_bound(file_name);
+        if (position < leaf->size() && leaf->names.compare(position, file_name) == 0) {
+            std::cout << "File already exists!" << std::endl; // Duplicate insertion
+            return;
+        }
+
+        leaf->names.insert(position, file_name);
+        leaf->types.insert(position, file_type);
+        std::copy_backward(leaf->sizes + position, leaf->sizes + leaf->size() - 1, leaf->sizes + leaf->size());
+        leaf->sizes[position] = file_size;
+        ++file_count;
+        if (leaf->size() <= leaf_capacity) return;
+
+        // Split upwards until a node has room for the new separator
+        std::string separator;
+        Node* right = split(leaf, separator);
+        while (!path.empty()) {
+            auto [parent, child] = path.back();
+            path.pop_back();
+            parent->separators.insert(child, separator);
+            std::copy_backward(parent->children + child + 1, parent->children + parent->child_count() - 1,
+                parent->children + parent->child_count());
+            parent->children[child + 1] = right;
+            if (parent->child_count() <= inner_capacity) return;
+            right = split(parent, separator);
+        }
+        Inner* new_root = new Inner();
+        new_root->separators.insert(0, separator);
+        new_root->children[0] = root;
+        new_root->children[1] = right;
+        root = new_root;
+        ++levels;
+    }
+
+    void delete_file(const std::string& file_name) {
+        if (!root) return; // Empty tree
+        Leaf* leaf = find_leaf(file_name);
+        size_t position = leaf->names.lower_bound(file_name);
+        if (position == leaf->size() || leaf->names.compare(position, file_name) != 0) return; // File not found
+
+        leaf->names.erase(position);
+        leaf->types.erase(position);
+        std::copy(leaf->sizes + position + 1, leaf->sizes + leaf->size() + 1, leaf->sizes + position);
+        --file_count;
+    }
+
+    void rename_file(const std::string& old_name, const std::string& new_name) {
+        std::optional<FileInfo> file = search(old_name);
+        if (!file) return; // File not found
+        if (search(new_name)) return; // New name already exists
+
+        insert(new_name, file->file_type, file->file_size);
+        delete_file(old_name);
+    }
+
+    std::optional<FileInfo> search(const std::string& file_name) const {
+        if (!root) return std::nullopt;
+        Leaf* leaf = find_leaf(file_name);
+        size_t position = leaf->names.lower_bound(file_name);
+        if (position == leaf->size() || leaf->names.compare(position, file_name) != 0) return std::nullopt;
+        return FileInfo{ file_name, std::string(leaf->types.view(position)), leaf->sizes[position] };
+    }
+
+    /**
+     * @brief Calls visitor(name, type, size) for every file with first <= name <= last, in
+     * name order, following the leaf links.
+     *
+     * The views passed to the visitor are only valid during the call. A visitor returning
+     * false ends the scan; returns false if it was ended early.
+     */
+    template <typename Visitor>
+    bool range(std::string_view first, std::string_view last, Visitor visitor) const {
+        if (!root || last < first) return true;
+        Leaf* leaf = find_leaf(first);
+        size_t position = leaf->names.lower_bound(first);
+        std::string name;
+        for (; leaf; leaf = leaf->next, position = 0) {
+            for (; position < leaf->size(); ++position) {
+                if (leaf->names.compare(position, last) > 0) return true;
+                leaf->names.key(position, name);
+                if (!bplus_detail::visit(visitor, name, leaf->types.view(position), leaf->sizes[position])) return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<FileInfo> range(std::string_view first, std::string_view last) const {
+        std::vector<FileInfo> result;
+        range(first, last, [&](std::string_view name, std::string_view type, int size) {
+            result.push_back(FileInfo{ std::string(name), std::string(type), size });
+            });
+        return result;
+    }
+
+    // Calls visitor(name, type, size) for every file in name order, same early exit as range
+    template <typename Visitor>
+    bool for_each(Visitor visitor) const {
+        std::string name;
+        for (Leaf* leaf = leftmost_leaf(); leaf; leaf = leaf->next) {
+            for (size_t i = 0; i < leaf->size(); ++i) {
+                leaf->names.key(i, name);
+                if (!bplus_detail::visit(visitor, name, leaf->types.view(i), leaf->sizes[i])) return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<FileInfo> inorder() const {
+        std::vector<FileInfo> result;
+        result.reserve(file_count);
+        for_each([&](std::string_view name, std::string_view type, int size) {
+            result.push_back(FileInfo{ std::string(name), std::string(type), size });
+            });
+        return result;
+    }
+
+    // Scans the contiguous size column of every leaf, building names only for the matches
+    std::vector<FileInfo> search_by_size(int threshold) const {
+        std::vector<FileInfo> result;
+        for (Leaf* leaf = leftmost_leaf(); leaf; leaf = leaf->next) {
+            for (size_t i = 0; i < leaf->size(); ++i) {
+                if (leaf->sizes[i] <= threshold) continue;
+                result.push_back(FileInfo{ leaf->names.key(i), std::string(leaf->types.view(i)), leaf->sizes[i] });
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Replaces the contents with files, which must be sorted by strictly increasing name.
+     *
+     * Leaves are filled left to right and every inner level is built from the one below, so
+     * loading is O(n) instead of n separate inserts.
+     */
+    void bulk_load(const std::vector<FileInfo>& files) {
+        for (size_t i = 1; i < files.size(); ++i)
+            if (!(files[i - 1].file_name < files[i].file_name))
+                throw std::invalid_argument("bulk_load: names must be sorted and unique");
+
+        clear();
+        if (files.empty()) return;
+
+        std::vector<std::string> names(files.size());
+        for (size_t i = 0; i < files.size(); ++i) names[i] = files[i].file_name;
+
+        // Spread the files evenly so that no leaf ends up nearly empty
+        const size_t leaf_count = (files.size() + leaf_capacity - 1) / leaf_capacity;
+        std::vector<Node*> nodes;
+        std::vector<std::string> firsts;
+        Leaf* previous = nullptr;
+        for (size_t l = 0; l < leaf_count; ++l) {
+            size_t begin = files.size() * l / leaf_count, end = files.size() * (l + 1) / leaf_count;
+            Leaf* leaf = new Leaf();
+            leaf->names.assign(names, begin, end);
+            for (size_t i = begin; i < end; ++i) {
+                leaf->types.push_back(files[i].file_type);
+                leaf->sizes[i - begin] = files[i].file_size;
+            }
+            if (previous) previous->next = leaf;
+            previous = leaf;
+            nodes.push_back(leaf);
+            firsts.push_back(names[begin]);
+        }
+
+        levels = 1;
+        while (nodes.size() > 1) {
+            nodes = build_level(nodes, firsts,
+                [](const std::vector<Node*>& children, const std::vector<std::string>& keys, size_t begin, size_t end) {
+                    Inner* inner = new Inner();
+                    inner->separators.assign(keys, begin + 1, end);
+                    std::copy(children.begin() + begin, children.begin() + end, inner->children);
+                    return static_cast<Node*>(inner);
+                });
+            ++levels;
+        }
+        root = nodes[0];
+        file_count = files.size();
+    }
+
+    size_t size() const { return file_count; }
+    int height() const { return levels; }
+};
+
+#endif // BPLUS_FILE_SYSTEM_HPP
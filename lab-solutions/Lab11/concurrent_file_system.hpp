@@ -0,0 +1,343 @@
+#ifndef CONCURRENT_FILE_SYSTEM_HPP
+#define CONCURRENT_FILE_SYSTEM_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <optional>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+#include "file.hpp"
+
+
+// Catalog for many concurrent readers and serialized writers.
+//
+// The tree is a persistent AVL tree: writers never modify a node that readers can reach.
+// Under a writer mutex, an operation copies the nodes on its path (path copying), rotates and
+// relinks only those copies, and finally publishes the new root with one atomic store. A reader
+// loads the root once and sees a consistent version of the whole catalog for the rest of its
+// operation without taking any lock. A rename is an insert and a delete published together, so
+// no reader ever sees both names or neither.
+//
+// Replaced nodes are reclaimed with epoch-based reclamation: a reader announces the global
+// epoch in a slot before loading the root, a writer tags the nodes it unlinked with the epoch at
+// publication and then advances the epoch, and a tagged node is freed once every announced
+// epoch is newer than its tag, i.e. once no reader that could have loaded the old root is left.
+//
+// Every node also stores the largest file_size in its subtree, so search_by_size skips
+// subtrees without a match and costs O(k log n) for k results.
+class ConcurrentFileSystem {
+    struct Node {
+        std::string file_name;
+        std::string file_type;
+        int file_size;
+        Node* left;
+        Node* right;
+        int height;
+        int max_size;           // Largest file_size in this subtree
+        std::uint64_t version;  // Write that created the node; only nodes of the current write are mutable
+
+        Node(std::string name, std::string type, int size, std::uint64_t version)
+            : file_name(std::move(name)), file_type(std::move(type)), file_size(size),
+            left(nullptr), right(nullptr), height(1), max_size(size), version(version) {
+        }
+    };
+
+    // One reader announcement per cache line; 0 means the slot is free
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch{ 0 };
+    };
+    static constexpr size_t slot_count = 128;
+
+    std::atomic<Node*> root{ nullptr };
+    std::atomic<size_t> file_count{ 0 };
+    std::atomic<std::uint64_t> global_epoch{ 1 };
+    Slot slots[slot_count];
+
+    std::mutex writer;
+    std::uint64_t write_version = 0;
+    std::vector<Node*> unlinked;                              // Unlinked by the current write
+    std::vector<std::pair<std::uint64_t, Node*>> retired;     // (epoch at unlink, node)
+
+    // Announces the reader for as long as it lives
+    class ReadGuard {
+        Slot* slot;
+
+    public:
+        explicit ReadGuard(ConcurrentFileSystem& fs) {
+            size_t start = std::hash<std::thread::id>{}(std::this_thread::get_id()) % slot_count;
+            for (size_t attempt = 0;; ++attempt) {
+                Slot& candidate = fs.slots[(start + attempt) % slot_count];
+                std::uint64_t expected = 0;
+                if (candidate.epoch.compare_exchange_strong(expected, fs.global_epoch.load())) {
+                    slot = &candidate;
+                    return;
+                }
+                if (attempt % slot_count == slot_count - 1) std::this_thread::yield(); // All slots taken
+            }
+        }
+
+        ~ReadGuard() { slot->epoch.store(0); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    };
+
+    //----------------------------------- Path copying -------------------------------------//
+
+    static int height(const Node* node) { return node ? node->height : 0; }
+    static int max_size(const Node* node) { return node ? node->max_size : std::numeric_limits<int>::min(); }
+
+    static void update(Node* node) {
+        node->height = 1 + std::max(height(node->left), height(node->right));
+        node->max_size = std::max({ node->file_size, max_size(node->left), max_size(node->right) });
+    }
+
+    static int balance_factor(const Node* node) { return height(node->left) - height(node->right); }
+
+    // The node itself if this write created it, otherwise a mutable copy; the original is
+    // unlinked from the version being built
+    Node* own(Node* node) {
+        if (node->version == write_version) return node;
+        Node* copy = new Node(node->file_name, node->file_type, node->file_size, write_version);
+        copy->left = node->left;
+        copy->right = node->right;
+        copy->height = node->height;
+        copy->max_size = node->max_size;
+        unlinked.push_back(node);
+        return copy;
+    }
+
+    // Drops a node from the version being built; readers may still hold it unless it is new
+    void discard(Node* node) {
+        if (node->version == write_version) delete node;
+        else unlinked.push_back(node);
+    }
+
+    Node* rotate_right(Node* node) {
+        Node* pivot = own(node->left);
+        node->left = pivot->right;
+        pivot->right = node;
+        update(node);
+        update(pivot);
+        return pivot;
+    }
+
+    Node* rotate_left(Node* node) {
+        Node* pivot = own(node->right);
+        node->right = pivot->left;
+        pivot->left = node;
+        update(node);
+        update(pivot);
+        return pivot;
+    }
+
+    // node is owned and its subtrees are balanced; returns the new subtree root
+    Node* rebalance(Node* node) {
+        update(node);
+        int balance = balance_factor(node);
+        if (balance > 1) {
+            if (balance_factor(node->left) < 0) node->left = rotate_left(own(node->left));
+            return rotate_right(node);
+        }
+        if (balance < -1) {
+            if (balance_factor(node->right) > 0) node->right = rotate_right(own(node->right));
+            return rotate_left(node);
+        }
+        return node;
+    }
+
+    // Recursion is bounded by the AVL height, about 1.44 log2(n)
+    Node* insert(Node* node, const std::string& name, const std::string& type, int size) {
+        if (!node) return new Node(name, type, size, write_version);
+        node = own(node);
+        if (name < node->file_name) node->left = insert(node->left, name, type, size);
+        else node->right = insert(node->right, name, type, size);
+        return rebalance(node);
+    }
+
+    // Unlinks the smallest node of a non-empty subtree into minimum
+    Node* erase_min(Node* node, Node*& minimum) {
+        if (!node->left) {
+            minimum = node;
+            return node->right;
+        }
+        node = own(node);
+        node->left = erase_min(node->left, minimum);
+        return rebalance(node);
+    }
+
+    Node* erase(Node* node, const std::string& name) {
+        if (name == node->file_name) {
+            if (!node->left || !node->right) {
+                Node* child = node->left ? node->left : node->right;
+                discard(node);
+                return child;
+            }
+            Node* successor = nullptr;
+            Node* right = erase_min(node->right, successor);
+            Node* replacement = own(successor); // The successor moves up, as a copy unless it is new
+            replacement->left = node->left;
+            replacement->right = right;
+            discard(node);
+            return rebalance(replacement);
+        }
+        node = own(node);
+        if (name < node->file_name) node->left = erase(node->left, name);
+        else node->right = erase(node->right, name);
+        return rebalance(node);
+    }
+
+    static Node* find(Node* node, const std::string& name) {
+        while (node && node->file_name != name) node = name < node->file_name ? node->left : node->right;
+        return node;
+    }
+
+    //------------------------------------ Reclamation -------------------------------------//
+
+    // Makes the version built by the current write visible and retires what it replaced
+    void publish(Node* new_root) {
+        root.store(new_root);
+        std::uint64_t epoch = global_epoch.load();
+        for (Node* node : unlinked) retired.emplace_back(epoch, node);
+        unlinked.clear();
+        global_epoch.store(epoch + 1);
+        reclaim();
+    }
+
+    // Frees the retired nodes that no announced reader can still see
+    void reclaim() {
+        std::uint64_t oldest = global_epoch.load();
+        for (const Slot& slot : slots) {
+            std::uint64_t epoch = slot.epoch.load();
+            if (epoch != 0) oldest = std::min(oldest, epoch);
+        }
+        size_t kept = 0;
+        for (auto& [epoch, node] : retired) {
+            if (epoch < oldest) delete node;
+            else retired[kept++] = { epoch, node };
+        }
+        retired.resize(kept);
+    }
+
+    static void destroy(Node* node) {
+        std::vector<Node*> stack;
+        if (node) stack.push_back(node);
+        while (!stack.empty()) {
+            node = stack.back();
+            stack.pop_back();
+            if (node->left) stack.push_back(node->left);
+            if (node->right) stack.push_back(node->right);
+            delete node;
+        }
+    }
+
+    static FileInfo info(const Node* node) { return FileInfo{ node->file_name, node->file_type, node->file_size }; }
+
+public:
+    ConcurrentFileSystem() = default;
+
+    // No reader or writer may still be running
+    ~ConcurrentFileSystem() {
+        destroy(root.load());
+        for (auto& entry : retired) delete entry.second;
+    }
+
+    ConcurrentFileSystem(const ConcurrentFileSystem&) = delete;
+    ConcurrentFileSystem& operator=(const ConcurrentFileSystem&) = delete;
+
+    //-------------------------------------- Writers ---------------------------------------//
+
+    void insert(const std::string& file_name, const std::string& file_type, int file_size) {
+        std::lock_guard<std::mutex> lock(writer);
+        Node* current = root.load();
+        if (find(current, file_name)) {
+            std::cout << "File already exists!" << std::endl; // Duplicate insertion
+            return;
+        }
+        ++write_version;
+        publish(insert(current, file_name, file_type, file_size));
+        ++file_count;
+    }
+
+    void delete_file(const std::string& file_name) {
+        std::lock_guard<std::mutex> lock(writer);
+        Node* current = root.load();
+        if (!find(current, file_name)) return; // File not found (or empty tree)
+        ++write_version;
+        publish(erase(current, file_name));
+        --file_count;
+    }
+
+    void rename_file(const std::string& old_name, const std::string& new_name) {
+        std::lock_guard<std::mutex> lock(writer);
+        Node* current = root.load();
+        Node* file = find(current, old_name);
+        if (!file) return; // File not found
+        if (find(current, new_name)) return; // New name already exists
+
+        ++write_version;
+        Node* next = insert(current, new_name, file->file_type, file->file_size);
+        publish(erase(next, old_name));
+    }
+
+    //-------------------------------------- Readers ---------------------------------------//
+    // Lock-free apart from claiming a reader slot; results are copies, since nodes may be
+    // reclaimed as soon as the read ends.
+
+    std::optional<FileInfo> search(const std::string& file_name) {
+        ReadGuard guard(*this);
+        Node* node = find(root.load(), file_name);
+        if (!node) return std::nullopt;
+        return info(node);
+    }
+
+    // Files with file_size > threshold in name order, skipping subtrees whose largest file is
+    // not above the threshold
+    std::vector<FileInfo> search_by_size(int threshold) {
+        ReadGuard guard(*this);
+        std::vector<FileInfo> result;
+        std::vector<Node*> stack;
+        Node* node = root.load();
+        while (node || !stack.empty()) {
+            while (node && node->max_size > threshold) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            if (stack.empty()) break;
+            node = stack.back();
+            stack.pop_back();
+            if (node->file_size > threshold) result.push_back(info(node));
+            node = node->right;
+        }
+        return result;
+    }
+
+    std::vector<FileInfo> inorder() {
+        ReadGuard guard(*this);
+        std::vector<FileInfo> result;
+        std::vector<Node*> stack;
+        Node* node = root.load();
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            result.push_back(info(node));
+            node = node->right;
+        }
+        return result;
+    }
+
+    size_t size() const { return file_count.load(); }
+};
+
+#endif // CONCURRENT_FILE_SYSTEM_HPP
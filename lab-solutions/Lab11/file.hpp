@@ -0,0 +1,52 @@
+#ifndef FILE_HPP
+#define FILE_HPP
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+
+struct File {
+    std::string file_name;
+    std::string file_type;
+    int file_size;
+
+    File* left;
+    File* right;
+    int height; // Height of the subtree rooted here, a leaf has height 1
+
+    File(std::string _fn, std::string _ft, int _fs) :
+        file_name(_fn), file_type(_ft), file_size(_fs), left(nullptr), right(nullptr), height(1) {
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const File& file) {
+        os << "File Name: " << file.file_name << ", Type: " << file.file_type << ", Size: " << file.file_size << "MB";
+        return os;
+    }
+};
+
+// A file by value, for the trees that store their entries in their own layout (BPlusFileSystem)
+// or share nodes between threads (ConcurrentFileSystem) and have no File nodes to hand out
+struct FileInfo {
+    std::string file_name;
+    std::string file_type;
+    int file_size;
+
+    friend std::ostream& operator<<(std::ostream& os, const FileInfo& file) {
+        os << "File Name: " << file.file_name << ", Type: " << file.file_type << ", Size: " << file.file_size << "MB";
+        return os;
+    }
+};
+
+// Calls visitor(file) for the visitor-based traversals. A visitor either returns nothing or a bool,
+// where false stops the traversal early; returns whether the traversal should go on.
+template <typename Visitor>
+bool visit_file(Visitor& visitor, File* file) {
+    if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, File*>>) {
+        visitor(file);
+        return true;
+    }
+    else return static_cast<bool>(visitor(file));
+}
+
+#endif // FILE_HPP
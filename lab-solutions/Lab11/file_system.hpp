@@ -0,0 +1,552 @@
+#ifndef FILE_SYSTEM_HPP
+#define FILE_SYSTEM_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
+
+#if __has_include(<generator>)
+#include <generator>
+#endif
+
+#include "file.hpp"
+#include "size_index.hpp"
+
+
+// One rejected entry of insert_batch or rename_batch
+struct BatchError {
+    enum class Kind {
+        Duplicate,  // insert_batch: the name exists already or earlier in the batch
+        NotFound,   // rename_batch: no file has the old name
+        NameTaken   // rename_batch: the new name belongs to another file
+    };
+    Kind kind;
+    std::string file_name;
+
+    friend std::ostream& operator<<(std::ostream& os, const BatchError& error) {
+        switch (error.kind) {
+        case Kind::Duplicate: os << "File already exists: "; break;
+        case Kind::NotFound: os << "File not found: "; break;
+        case Kind::NameTaken: os << "New name already exists: "; break;
+        }
+        return os << error.file_name;
+    }
+};
+
+struct BatchResult {
+    size_t applied = 0;               // Entries that changed the tree
+    std::vector<BatchError> errors;   // Entries that were skipped, in input order
+
+    bool ok() const { return errors.empty(); }
+};
+
+// AVL tree of files ordered by name. All operations are iterative: insert and delete remember
+// the links they walked through and rebalance on the way back up, and the traversals use an
+// explicit stack. The height stays below 1.45 log2(n), so files inserted in sorted-name order
+// (file1.txt, file2.txt, ...) no longer degrade the tree into a list.
+//
+// Nodes are never copied into each other: deleting a node with two children moves its in-order
+// successor node into its place, so a File* returned by search stays valid until that file is
+// deleted. Callers must not change file_name or file_size through it, both are index keys.
+class FileSystem {
+    File* root;
+    size_t file_count;
+    SizeIndex size_index; // Secondary index on file_size, kept in sync by insert and delete_file
+
+private:
+    static int height(File* node) { return node ? node->height : 0; }
+
+    static void update_height(File* node) { node->height = 1 + std::max(height(node->left), height(node->right)); }
+
+    static int balance_factor(File* node) { return height(node->left) - height(node->right); }
+
+    static void rotate_right(File*& link) {
+        File* node = link;
+        File* pivot = node->left;
+        node->left = pivot->right;
+        pivot->right = node;
+        update_height(node);
+        update_height(pivot);
+        link = pivot;
+    }
+
+    static void rotate_left(File*& link) {
+        File* node = link;
+        File* pivot = node->right;
+        node->right = pivot->left;
+        pivot->left = node;
+        update_height(node);
+        update_height(pivot);
+        link = pivot;
+    }
+
+    // Restores the AVL property at link, whose subtrees are already balanced
+    static void rebalance(File*& link) {
+        File* node = link;
+        update_height(node);
+        int balance = balance_factor(node);
+        if (balance > 1) {
+            if (balance_factor(node->left) < 0) rotate_left(node->left);
+            rotate_right(link);
+        }
+        else if (balance < -1) {
+            if (balance_factor(node->right) > 0) rotate_right(node->right);
+            rotate_left(link);
+        }
+    }
+
+    // Walks the recorded links bottom-up, fixing heights and rotating where needed
+    static void rebalance_path(std::vector<File**>& path) {
+        for (size_t i = path.size(); i-- > 0;)
+            if (*path[i]) rebalance(*path[i]);
+    }
+
+    // insert without the message; returns false for a duplicate name
+    bool try_insert(const std::string& file_name, const std::string& file_type, int file_size) {
+        std::vector<File**> path;
+        File** link = &root;
+        while (*link) {
+            path.push_back(link);
+            if (file_name < (*link)->file_name) link = &(*link)->left;
+            else if (file_name > (*link)->file_name) link = &(*link)->right;
+            else return false;
+        }
+        *link = new File(file_name, file_type, file_size);
+        size_index.insert(*link);
+        ++file_count;
+        rebalance_path(path);
+        return true;
+    }
+
+    // Relinks nodes, sorted by name, into a perfectly balanced tree in O(n) without comparisons
+    // or rotations: the middle node of every range becomes the root of its subtree. A range of
+    // m nodes has height floor(log2 m) + 1, so heights are known without visiting the children.
+    // The size index is left alone.
+    void relink_balanced(const std::vector<File*>& nodes) {
+        root = nullptr;
+        struct Range { size_t lo, hi; File** link; };
+        std::vector<Range> stack{ { 0, nodes.size(), &root } };
+        while (!stack.empty()) {
+            Range range = stack.back();
+            stack.pop_back();
+            if (range.lo == range.hi) {
+                *range.link = nullptr;
+                continue;
+            }
+            size_t mid = range.lo + (range.hi - range.lo) / 2;
+            File* node = nodes[mid];
+            node->height = 1;
+            for (size_t m = range.hi - range.lo; m > 1; m /= 2) ++node->height;
+            *range.link = node;
+            stack.push_back({ range.lo, mid, &node->left });
+            stack.push_back({ mid + 1, range.hi, &node->right });
+        }
+        file_count = nodes.size();
+    }
+
+    // Whether a batch of this many changes is cheaper as one O(n) merge and rebuild than as
+    // separate O(log n) operations
+    bool rebuild_pays_off(size_t batch) const {
+        size_t depth = 1;
+        for (size_t n = file_count; n > 1; n /= 2) ++depth;
+        return batch * depth >= file_count;
+    }
+
+    void clear(File*& root) {
+        std::vector<File*> stack;
+        if (root) stack.push_back(root);
+        while (!stack.empty()) {
+            File* node = stack.back();
+            stack.pop_back();
+            if (node->left) stack.push_back(node->left);
+            if (node->right) stack.push_back(node->right);
+            delete node;
+        }
+        root = nullptr;
+        file_count = 0;
+        size_index.clear();
+    }
+
+
+public:
+    FileSystem() : root(nullptr), file_count(0) {}
+
+    ~FileSystem() { clear(root); }
+
+    FileSystem(const FileSystem&) = delete;
+    FileSystem& operator=(const FileSystem&) = delete;
+
+    void insert(const std::string& file_name, const std::string& file_type, int file_size) {
+        if (!try_insert(file_name, file_type, file_size)) std::cout << "File already exists!" << std::endl; // Duplicate insertion
+    }
+
+    void delete_file(const std::string& file_name) {
+        std::vector<File**> path;
+        File** link = &root;
+        while (*link && (*link)->file_name != file_name) {
+            path.push_back(link);
+            link = file_name < (*link)->file_name ? &(*link)->left : &(*link)->right;
+        }
+        if (!*link) return; // File not found (or empty tree)
+
+        File* node = *link;
+        size_index.erase(node);
+        if (!node->left || !node->right) {
+            *link = node->left ? node->left : node->right;
+        }
+        else {
+            // Unlink the in-order successor and move it into the deleted node's place
+            path.push_back(link);
+            size_t node_index = path.size(); // Index the link &node->right will get in path
+            File** successor_link = &node->right;
+            while ((*successor_link)->left) {
+                path.push_back(successor_link);
+                successor_link = &(*successor_link)->left;
+            }
+            File* successor = *successor_link;
+            *successor_link = successor->right;
+
+            successor->left = node->left;
+            successor->right = node->right;
+            *link = successor;
+            // Links recorded inside the deleted node now live in the successor
+            if (node_index < path.size()) path[node_index] = &successor->right;
+            path.push_back(successor_link == &node->right ? &successor->right : successor_link);
+        }
+        delete node;
+        --file_count;
+        rebalance_path(path);
+    }
+
+    /**
+     * @brief Replaces the contents with the files in [first, last), which must be sorted by
+     * strictly increasing file_name. Elements need file_name, file_type and file_size members.
+     *
+     * The name tree is built balanced in O(n); the size index still costs one O(log n) insert
+     * per file.
+     */
+    template <typename Iterator>
+    void assign_sorted(Iterator first, Iterator last) {
+        for (Iterator it = first; it != last; ++it)
+            if (std::next(it) != last && !(it->file_name < std::next(it)->file_name))
+                throw std::invalid_argument("assign_sorted: names must be sorted and unique");
+
+        clear(root);
+        std::vector<File*> nodes;
+        nodes.reserve(static_cast<size_t>(std::distance(first, last)));
+        for (Iterator it = first; it != last; ++it) {
+            nodes.push_back(new File(std::string(it->file_name), std::string(it->file_type), it->file_size));
+            size_index.insert(nodes.back());
+        }
+        relink_balanced(nodes);
+    }
+
+    /**
+     * @brief Inserts many files at once. Names that exist already, or appear earlier in the
+     * batch, are reported in the result instead of printed.
+     *
+     * The batch is sorted once. A large batch (relative to the tree) is merged with the
+     * in-order sequence of the existing nodes in one pass and the tree is relinked balanced,
+     * reusing every node: O(n + m log m) instead of m separate inserts with rebalancing.
+     */
+    BatchResult insert_batch(const std::vector<FileInfo>& files) {
+        BatchResult result;
+        std::vector<size_t> order(files.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return files[a].file_name < files[b].file_name; });
+
+        std::vector<bool> rejected(files.size(), false);
+        for (size_t i = 1; i < order.size(); ++i)
+            if (files[order[i]].file_name == files[order[i - 1]].file_name) rejected[order[i]] = true;
+
+        if (!rebuild_pays_off(files.size())) {
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (!rejected[i] && !try_insert(files[i].file_name, files[i].file_type, files[i].file_size)) rejected[i] = true;
+                if (!rejected[i]) ++result.applied;
+            }
+        }
+        else {
+            // Merge the sorted batch into the in-order node sequence
+            std::vector<File*> existing = inorder(), merged, added;
+            merged.reserve(existing.size() + files.size());
+            size_t e = 0;
+            for (size_t index : order) {
+                if (rejected[index]) continue;
+                const FileInfo& file = files[index];
+                while (e < existing.size() && existing[e]->file_name < file.file_name) merged.push_back(existing[e++]);
+                if (e < existing.size() && existing[e]->file_name == file.file_name) {
+                    rejected[index] = true;
+                    continue;
+                }
+                added.push_back(new File(file.file_name, file.file_type, file.file_size));
+                merged.push_back(added.back());
+            }
+            merged.insert(merged.end(), existing.begin() + e, existing.end());
+            relink_balanced(merged);
+            size_index.rebuild(added, [](File*) { return true; });
+            result.applied = added.size();
+        }
+
+        for (size_t i = 0; i < files.size(); ++i)
+            if (rejected[i]) result.errors.push_back({ BatchError::Kind::Duplicate, files[i].file_name });
+        return result;
+    }
+
+    /**
+     * @brief Applies many (old name, new name) renames at once, with the same outcome as
+     * calling rename_file for each pair in order. Pairs whose old name does not exist or whose
+     * new name is taken at that point are reported in the result instead of applied.
+     *
+     * The pairs are first resolved to final moves (file -> final name) with hash lookups, so a
+     * chain a -> b -> c or a swap through a temporary name moves each node once. Renamed nodes
+     * are reused; a large batch takes them out of the in-order sequence, sorts them by their new
+     * names, merges them back in one pass and relinks the tree balanced.
+     */
+    BatchResult rename_batch(const std::vector<std::pair<std::string, std::string>>& renames) {
+        BatchResult result;
+        std::unordered_map<std::string, File*> moved;    // Name during the batch -> its node
+        std::unordered_set<std::string> vacated;         // Names of nodes that moved away
+        auto lookup = [&](const std::string& name) -> File* {
+            auto it = moved.find(name);
+            if (it != moved.end()) return it->second;
+            return vacated.count(name) ? nullptr : search(name);
+        };
+
+        for (const auto& [old_name, new_name] : renames) {
+            File* file = lookup(old_name);
+            if (!file) {
+                result.errors.push_back({ BatchError::Kind::NotFound, old_name });
+                continue;
+            }
+            if (lookup(new_name)) {
+                result.errors.push_back({ BatchError::Kind::NameTaken, new_name });
+                continue;
+            }
+            if (!moved.erase(old_name)) vacated.insert(old_name);
+            moved[new_name] = file;
+            ++result.applied;
+        }
+
+        // Nodes whose final name differs from their current one
+        std::vector<std::pair<std::string, File*>> moves;
+        for (auto& [name, file] : moved)
+            if (name != file->file_name) moves.emplace_back(name, file);
+        if (moves.empty()) return result;
+        std::sort(moves.begin(), moves.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        if (!rebuild_pays_off(moves.size())) {
+            // Delete every source before inserting, so that swaps never collide
+            std::vector<FileInfo> targets;
+            for (auto& [name, file] : moves) targets.push_back({ name, file->file_type, file->file_size });
+            for (auto& move : moves) delete_file(move.second->file_name);
+            for (const FileInfo& file : targets) try_insert(file.file_name, file.file_type, file.file_size);
+            return result;
+        }
+
+        // Mark the moving nodes with height 0, which relink_balanced overwrites afterwards
+        std::vector<File*> staying, merged, renamed;
+        for (auto& move : moves) move.second->height = 0;
+        for_each_inorder([&](File* file) { if (file->height != 0) staying.push_back(file); });
+        merged.reserve(file_count);
+        size_t s = 0;
+        for (auto& [name, file] : moves) {
+            while (s < staying.size() && staying[s]->file_name < name) merged.push_back(staying[s++]);
+            file->file_name = name;
+            merged.push_back(file);
+            renamed.push_back(file);
+        }
+        merged.insert(merged.end(), staying.begin() + s, staying.end());
+        // The name is part of the index key: drop the old entries of the renamed files, add new ones
+        size_index.rebuild(renamed, [](File* file) { return file->height != 0; });
+        relink_balanced(merged);
+        return result;
+    }
+
+    void rename_file(const std::string& old_name, const std::string& new_name) {
+        File* file = search(old_name);
+        File* new_name_exists = search(new_name);
+
+        if (!file) return; // File not found
+        if (new_name_exists) return; // New name already exists
+
+        insert(new_name, file->file_type, file->file_size);
+        delete_file(old_name);
+    }
+
+    File* search(const std::string& file_name) {
+        File* node = root;
+        while (node && node->file_name != file_name)
+            node = file_name < node->file_name ? node->left : node->right;
+        return node;
+    }
+
+    // Files with file_size > threshold, in ascending size order, O(log n + k) through the size index
+    std::vector<File*> search_by_size(int threshold) {
+        std::vector<File*> result;
+        size_index.collect_larger_than(threshold, result);
+        return result;
+    }
+
+    // Number of files with file_size > threshold, O(log n)
+    size_t count_larger_than(int threshold) const { return size_index.count_larger_than(threshold); }
+
+    //------------------------------------- Visitors ---------------------------------------//
+    // Stream the files to visitor(File*) without building a vector. A visitor returning false
+    // stops the traversal, so "the first k files" costs O(log n + k); each for_each returns
+    // false if it was stopped early.
+
+    // Ascending size order, through the size index
+    template <typename Visitor>
+    bool for_each_larger_than(int threshold, Visitor visitor) const {
+        return size_index.for_each_larger_than(threshold, visitor);
+    }
+
+    template <typename Visitor>
+    bool for_each_inorder(Visitor visitor) const {
+        std::vector<File*> stack;
+        stack.reserve(height(root));
+        File* node = root;
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            if (!visit_file(visitor, node)) return false;
+            node = node->right;
+        }
+        return true;
+    }
+
+    template <typename Visitor>
+    bool for_each_preorder(Visitor visitor) const {
+        std::vector<File*> stack;
+        stack.reserve(height(root) + 1);
+        if (root) stack.push_back(root);
+        while (!stack.empty()) {
+            File* node = stack.back();
+            stack.pop_back();
+            if (!visit_file(visitor, node)) return false;
+            if (node->right) stack.push_back(node->right);
+            if (node->left) stack.push_back(node->left);
+        }
+        return true;
+    }
+
+    template <typename Visitor>
+    bool for_each_postorder(Visitor visitor) const {
+        // A node is visited once we come back up from its right subtree (or it has none)
+        std::vector<File*> stack;
+        stack.reserve(height(root));
+        File* node = root;
+        File* last = nullptr;
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            File* top = stack.back();
+            if (top->right && top->right != last) node = top->right;
+            else {
+                if (!visit_file(visitor, top)) return false;
+                last = top;
+                stack.pop_back();
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Lazy in-order range: for (File* file : fs.inorder_range()) { ... }
+     *
+     * The iterator keeps the O(log n) path to the current file and advances one file at a time,
+     * so breaking out of the loop early costs only the files visited. The tree must not be
+     * modified while a range is being iterated.
+     */
+    class InorderRange {
+        File* root;
+
+    public:
+        class iterator {
+            std::vector<File*> stack;
+
+            void push_left(File* node) {
+                for (; node; node = node->left) stack.push_back(node);
+            }
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = File*;
+            using difference_type = std::ptrdiff_t;
+            using pointer = File* const*;
+            using reference = File*;
+
+            iterator() = default;
+            explicit iterator(File* root) { push_left(root); }
+
+            File* operator*() const { return stack.back(); }
+
+            iterator& operator++() {
+                File* node = stack.back();
+                stack.pop_back();
+                push_left(node->right);
+                return *this;
+            }
+
+            // Only end() compares equal to an exhausted iterator
+            bool operator==(const iterator& other) const { return stack.empty() && other.stack.empty(); }
+            bool operator!=(const iterator& other) const { return !(*this == other); }
+        };
+
+        explicit InorderRange(File* root) : root(root) {}
+        iterator begin() const { return iterator(root); }
+        iterator end() const { return iterator(); }
+    };
+
+    InorderRange inorder_range() const { return InorderRange(root); }
+
+#if defined(__cpp_lib_generator)
+    // Coroutine form of inorder_range() for C++23 compilers that ship std::generator
+    std::generator<File*> inorder_generator() const {
+        for (File* file : inorder_range()) co_yield file;
+    }
+#endif
+
+    //--------------------------------- Materialized vectors ---------------------------------//
+
+    std::vector<File*> inorder() {
+        std::vector<File*> result;
+        result.reserve(file_count);
+        for_each_inorder([&](File* file) { result.push_back(file); });
+        return result;
+    }
+
+    std::vector<File*> preorder() {
+        std::vector<File*> result;
+        result.reserve(file_count);
+        for_each_preorder([&](File* file) { result.push_back(file); });
+        return result;
+    }
+
+    std::vector<File*> postorder() {
+        std::vector<File*> result;
+        result.reserve(file_count);
+        for_each_postorder([&](File* file) { result.push_back(file); });
+        return result;
+    }
+
+    size_t size() const { return file_count; }
+    int height() const { return height(root); }
+};
+
+#endif // FILE_SYSTEM_HPP
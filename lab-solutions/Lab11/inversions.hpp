@@ -0,0 +1,125 @@
+#ifndef INVERSIONS_HPP
+#define INVERSIONS_HPP
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstddef>
+
+// Inversion counters: the number of pairs (i, j) with i < j and arr[i] > arr[j].
+// Results are 64-bit, an array of n elements can have up to n(n - 1) / 2 inversions.
+
+namespace inversions_detail {
+
+    // Merges the sorted ranges [lo, mid) and [mid, hi) of arr into buffer and back, returning
+    // the number of pairs (left, right) with left > right
+    inline long long mergeCount(std::vector<int>& arr, std::vector<int>& buffer, size_t lo, size_t mid, size_t hi) {
+        long long count = 0;
+        size_t i = lo, j = mid, k = lo;
+        while (i < mid && j < hi) {
+            if (arr[j] < arr[i]) {
+                count += static_cast<long long>(mid - i); // arr[j] is smaller than everything left in [i, mid)
+                buffer[k++] = arr[j++];
+            }
+            else buffer[k++] = arr[i++];
+        }
+        while (i < mid) buffer[k++] = arr[i++];
+        while (j < hi) buffer[k++] = arr[j++];
+        std::copy(buffer.begin() + lo, buffer.begin() + hi, arr.begin() + lo);
+        return count;
+    }
+
+    // Bottom-up merge sort of arr[lo, hi), returning its inversions
+    inline long long sortCount(std::vector<int>& arr, std::vector<int>& buffer, size_t lo, size_t hi) {
+        long long count = 0;
+        const size_t run = 16;
+        // Insertion sort short runs, counting each shift as one inversion
+        for (size_t start = lo; start < hi; start += run) {
+            size_t end = std::min(hi, start + run);
+            for (size_t i = start + 1; i < end; ++i) {
+                int key = arr[i];
+                size_t j = i;
+                while (j > start && arr[j - 1] > key) {
+                    arr[j] = arr[j - 1];
+                    --j;
+                    ++count;
+                }
+                arr[j] = key;
+            }
+        }
+        for (size_t width = run; width < hi - lo; width *= 2)
+            for (size_t left = lo; left + width < hi; left += 2 * width)
+                count += mergeCount(arr, buffer, left, left + width, std::min(hi, left + 2 * width));
+        return count;
+    }
+}
+
+// O(n log n): merge sort on a copy, counting the pairs crossed by every merge step
+inline long long countInversionsMerge(const std::vector<int>& arr) {
+    if (arr.size() < 2) return 0;
+    std::vector<int> copy = arr, buffer(arr.size());
+    return inversions_detail::sortCount(copy, buffer, 0, copy.size());
+}
+
+// O(n log n): scans right to left, a Fenwick tree over the ranks counts how many smaller
+// values have already been seen
+inline long long countInversionsFenwick(const std::vector<int>& arr) {
+    std::vector<int> values = arr;
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+
+    std::vector<long long> tree(values.size() + 1, 0);
+    long long count = 0;
+    for (size_t i = arr.size(); i-- > 0;) {
+        size_t rank = std::lower_bound(values.begin(), values.end(), arr[i]) - values.begin(); // 0-based
+        for (size_t r = rank; r > 0; r -= r & (~r + 1)) count += tree[r]; // Seen values with rank < rank
+        for (size_t r = rank + 1; r < tree.size(); r += r & (~r + 1)) ++tree[r];
+    }
+    return count;
+}
+
+// Divide and conquer over threads: every thread sorts and counts one slice, then pairs of
+// neighbouring slices are merged level by level, each merge on its own thread.
+inline long long countInversionsParallel(const std::vector<int>& arr,
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+    const size_t n = arr.size();
+    const size_t min_slice = 1 << 15; // Smaller slices are not worth a thread
+    size_t slices = std::min<size_t>(threads, std::max<size_t>(1, n / min_slice));
+    if (slices <= 1) return countInversionsMerge(arr);
+
+    std::vector<int> copy = arr, buffer(n);
+    std::vector<size_t> bounds(slices + 1);
+    for (size_t s = 0; s <= slices; ++s) bounds[s] = n * s / slices;
+
+    std::vector<long long> counts(slices, 0);
+    std::vector<std::thread> pool;
+    for (size_t s = 0; s < slices; ++s)
+        pool.emplace_back([&, s]() { counts[s] = inversions_detail::sortCount(copy, buffer, bounds[s], bounds[s + 1]); });
+    for (auto& t : pool) t.join();
+
+    // Merge neighbouring slices until one is left; each merge writes a disjoint range
+    while (bounds.size() > 2) {
+        std::vector<size_t> merged{ 0 };
+        std::vector<long long> merged_counts;
+        pool.clear();
+        size_t pairs = (bounds.size() - 1) / 2;
+        merged_counts.assign(pairs, 0);
+        for (size_t p = 0; p < pairs; ++p) {
+            size_t lo = bounds[2 * p], mid = bounds[2 * p + 1], hi = bounds[2 * p + 2];
+            pool.emplace_back([&, p, lo, mid, hi]() {
+                merged_counts[p] = counts[2 * p] + counts[2 * p + 1] + inversions_detail::mergeCount(copy, buffer, lo, mid, hi);
+                });
+            merged.push_back(hi);
+        }
+        for (auto& t : pool) t.join();
+        if ((bounds.size() - 1) % 2 == 1) { // Odd slice out carries over to the next level
+            merged.push_back(bounds.back());
+            merged_counts.push_back(counts.back());
+        }
+        bounds.swap(merged);
+        counts.swap(merged_counts);
+    }
+    return counts[0];
+}
+
+#endif // INVERSIONS_HPP
@@ -0,0 +1,484 @@
+#ifndef PERSISTENT_FILE_SYSTEM_HPP
+#define PERSISTENT_FILE_SYSTEM_HPP
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <memory>
+#include <algorithm>
+
+#include "file_system.hpp"
+#include "../Lab10/Stopwatch.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PERSISTENCE_POSIX 1
+#elif defined(_WIN32)
+#include <io.h>
+#endif
+
+
+namespace persistence_detail {
+
+    inline std::uint32_t crc32(const char* data, size_t length) {
+        static const std::vector<std::uint32_t> table = []() {
+            std::vector<std::uint32_t> t(256);
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < length; ++i) crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    template <typename T>
+    void append_pod(std::string& buffer, T value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    inline void append_string(std::string& buffer, std::string_view s) {
+        append_pod(buffer, static_cast<std::uint32_t>(s.size()));
+        buffer.append(s.data(), s.size());
+    }
+
+    // Bounds-checked reader over a byte range; any read past the end sets failed
+    struct Cursor {
+        const char* data;
+        size_t size;
+        size_t position = 0;
+        bool failed = false;
+
+        template <typename T>
+        T pod() {
+            T value{};
+            if (position + sizeof(T) > size) failed = true;
+            else std::memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+            return value;
+        }
+
+        std::string_view string() {
+            std::uint32_t length = pod<std::uint32_t>();
+            if (failed || position + length > size) {
+                failed = true;
+                return std::string_view();
+            }
+            std::string_view s(data + position, length);
+            position += length;
+            return s;
+        }
+    };
+
+    // Read-only view of a whole file: mmap on POSIX, a plain read into memory elsewhere
+    class MappedFile {
+        const char* bytes = nullptr;
+        size_t length = 0;
+        std::vector<char> fallback;
+#if defined(PERSISTENCE_POSIX)
+        void* mapping = nullptr;
+#endif
+
+    public:
+        explicit MappedFile(const std::filesystem::path& path) {
+            if (!std::filesystem::exists(path)) return;
+            length = static_cast<size_t>(std::filesystem::file_size(path));
+            if (length == 0) return;
+#if defined(PERSISTENCE_POSIX)
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw std::runtime_error("Could not open file: " + path.string());
+            mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (mapping == MAP_FAILED) throw std::runtime_error("Could not map file: " + path.string());
+            bytes = static_cast<const char*>(mapping);
+#else
+            std::ifstream in(path, std::ios::binary);
+            fallback.resize(length);
+            if (!in.read(fallback.data(), static_cast<std::streamsize>(length))) throw std::runtime_error("Could not read file: " + path.string());
+            bytes = fallback.data();
+#endif
+        }
+
+        ~MappedFile() {
+#if defined(PERSISTENCE_POSIX)
+            if (mapping) ::munmap(mapping, length);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return bytes; }
+        size_t size() const { return length; }
+    };
+
+    // Append-only file with an explicit durability point
+    class LogWriter {
+#if defined(PERSISTENCE_POSIX)
+        int fd = -1;
+#else
+        std::FILE* file = nullptr;
+#endif
+        std::filesystem::path path;
+
+    public:
+        LogWriter(std::filesystem::path path, bool truncate) : path(std::move(path)) {
+#if defined(PERSISTENCE_POSIX)
+            fd = ::open(this->path.c_str(), O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+            if (fd < 0) throw std::runtime_error("Could not open file: " + this->path.string());
+#else
+            file = std::fopen(this->path.string().c_str(), truncate ? "wb" : "ab");
+            if (!file) throw std::runtime_error("Could not open file: " + this->path.string());
+#endif
+        }
+
+        ~LogWriter() {
+#if defined(PERSISTENCE_POSIX)
+            if (fd >= 0) ::close(fd);
+#else
+            if (file) std::fclose(file);
+#endif
+        }
+
+        LogWriter(const LogWriter&) = delete;
+        LogWriter& operator=(const LogWriter&) = delete;
+
+        void write(const std::string& buffer) {
+#if defined(PERSISTENCE_POSIX)
+            size_t written = 0;
+            while (written < buffer.size()) {
+                ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+                if (n < 0) throw std::runtime_error("Write failed: " + path.string());
+                written += static_cast<size_t>(n);
+            }
+#else
+            if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) throw std::runtime_error("Write failed: " + path.string());
+#endif
+        }
+
+        // Blocks until everything written so far is on stable storage
+        void sync() {
+#if defined(__linux__)
+            if (::fdatasync(fd) != 0) throw std::runtime_error("fsync failed: " + path.string());
+#elif defined(PERSISTENCE_POSIX)
+            if (::fsync(fd) != 0) throw std::runtime_error("fsync failed: " + path.string());
+#else
+            std::fflush(file);
+#if defined(_WIN32)
+            _commit(_fileno(file));
+#endif
+#endif
+        }
+
+        // Makes a rename inside directory durable (a no-op where directories cannot be synced)
+        static void sync_directory(const std::filesystem::path& directory) {
+#if defined(PERSISTENCE_POSIX)
+            int fd = ::open(directory.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            ::fsync(fd);
+            ::close(fd);
+#else
+            (void)directory;
+#endif
+        }
+    };
+}
+
+
+// Persistent FileSystem: a write-ahead log (WAL) of insert, delete and rename operations plus
+// compacted snapshots, both in a binary layout in one directory:
+//
+//     catalog.wal       sequence of records  [u32 body length][u32 CRC-32 of body][body]
+//                       body = [u64 LSN][u8 operation][operands], strings as [u32 length][bytes]
+//     catalog.snapshot  [header][entry array sorted by name][string pool], see SnapshotHeader
+//
+// Every operation gets the next log sequence number (LSN). Records are buffered and written
+// with a single fsync once group_size of them are pending (group commit), so a crash loses at
+// most the last group_size - 1 acknowledged operations; commit() forces the pending group out.
+// After snapshot_interval records a snapshot of the whole catalog is written (to a temporary
+// file, fsynced, then renamed over the old one) and the log is started afresh.
+//
+// Recovery maps the snapshot and builds the tree from its sorted entries in O(n), then replays
+// only the log records with an LSN above the snapshot's. A torn or corrupt record at the end of
+// the log (a crash in the middle of a write) ends the replay and is cut off.
+//
+// Integers are stored in native byte order; the files are not meant to move between machines.
+class PersistentFileSystem {
+public:
+    enum class Operation : std::uint8_t { Insert = 1, Delete = 2, Rename = 3 };
+
+    // First bytes of catalog.snapshot; entries follow immediately, the pool after them
+    struct SnapshotHeader {
+        char magic[8];               // "FSSNAP01"
+        std::uint64_t lsn;           // Last operation included in the snapshot
+        std::uint64_t count;         // Number of entries
+        std::uint64_t pool_offset;   // Start of the string pool from the start of the file
+        std::uint64_t pool_size;
+        std::uint32_t checksum;      // CRC-32 of the entries and the pool
+        std::uint32_t reserved;
+    };
+
+    struct SnapshotEntry {
+        std::uint64_t name_offset;   // Into the string pool
+        std::uint64_t type_offset;
+        std::uint32_t name_length;
+        std::uint32_t type_length;
+        std::int32_t file_size;
+        std::uint32_t reserved;
+    };
+
+    struct RecoveryStats {
+        size_t snapshot_files = 0;     // Files loaded from the snapshot
+        size_t replayed_records = 0;   // Log records applied on top of it
+        size_t skipped_records = 0;    // Log records already covered by the snapshot
+        bool truncated_tail = false;   // A torn record was cut off the end of the log
+        double seconds = 0.0;
+    };
+
+private:
+    std::filesystem::path directory;
+    size_t group_size;
+    size_t snapshot_interval;
+
+    FileSystem files;
+    std::uint64_t next_lsn = 1;
+    std::uint64_t snapshot_lsn = 0;
+    size_t log_records = 0;        // Records in the log since the last snapshot
+    size_t pending_records = 0;    // Records buffered since the last commit
+    std::string pending;
+    std::unique_ptr<persistence_detail::LogWriter> log;
+    RecoveryStats recovery;
+
+    std::filesystem::path log_path() const { return directory / "catalog.wal"; }
+    std::filesystem::path snapshot_path() const { return directory / "catalog.snapshot"; }
+
+    // Snapshot entries as seen by FileSystem::assign_sorted
+    struct SnapshotFile {
+        std::string_view file_name;
+        std::string_view file_type;
+        int file_size;
+    };
+
+    void append_record(Operation operation, std::string_view first, std::string_view second = {}, int file_size = 0) {
+        std::string body;
+        persistence_detail::append_pod(body, next_lsn++);
+        persistence_detail::append_pod(body, static_cast<std::uint8_t>(operation));
+        persistence_detail::append_string(body, first);
+        if (operation != Operation::Delete) persistence_detail::append_string(body, second);
+        if (operation == Operation::Insert) persistence_detail::append_pod(body, static_cast<std::int32_t>(file_size));
+
+        persistence_detail::append_pod(pending, static_cast<std::uint32_t>(body.size()));
+        persistence_detail::append_pod(pending, persistence_detail::crc32(body.data(), body.size()));
+        pending += body;
+        ++log_records;
+        if (++pending_records >= group_size) commit();
+    }
+
+    void after_operation() {
+        if (log_records >= snapshot_interval) snapshot();
+    }
+
+    void load_snapshot() {
+        persistence_detail::MappedFile mapped(snapshot_path());
+        if (mapped.size() == 0) return;
+        if (mapped.size() < sizeof(SnapshotHeader)) throw std::runtime_error("Corrupt snapshot: " + snapshot_path().string());
+
+        SnapshotHeader header;
+        std::memcpy(&header, mapped.data(), sizeof(header));
+        const size_t entries_size = header.count * sizeof(SnapshotEntry);
+        if (std::memcmp(header.magic, "FSSNAP01", 8) != 0 || sizeof(header) + entries_size != header.pool_offset ||
+            header.pool_offset + header.pool_size != mapped.size() ||
+            persistence_detail::crc32(mapped.data() + sizeof(header), entries_size + header.pool_size) != header.checksum)
+            throw std::runtime_error("Corrupt snapshot: " + snapshot_path().string());
+
+        // The entries are read in place from the mapping; only the tree nodes are allocated
+        const char* pool = mapped.data() + header.pool_offset;
+        std::vector<SnapshotFile> entries(header.count);
+        for (size_t i = 0; i < header.count; ++i) {
+            SnapshotEntry entry;
+            std::memcpy(&entry, mapped.data() + sizeof(header) + i * sizeof(SnapshotEntry), sizeof(entry));
+            entries[i] = { std::string_view(pool + entry.name_offset, entry.name_length),
+                std::string_view(pool + entry.type_offset, entry.type_length), entry.file_size };
+        }
+        files.assign_sorted(entries.begin(), entries.end());
+        snapshot_lsn = header.lsn;
+        next_lsn = header.lsn + 1;
+        recovery.snapshot_files = entries.size();
+    }
+
+    void replay_log() {
+        size_t valid_bytes = 0, file_bytes = 0;
+        {
+            persistence_detail::MappedFile mapped(log_path());
+            file_bytes = mapped.size();
+            while (valid_bytes < mapped.size()) {
+                persistence_detail::Cursor header{ mapped.data() + valid_bytes, mapped.size() - valid_bytes };
+                std::uint32_t length = header.pod<std::uint32_t>();
+                std::uint32_t checksum = header.pod<std::uint32_t>();
+                if (header.failed || header.position + length > header.size) break; // Torn write
+                const char* body_data = header.data + header.position;
+                if (persistence_detail::crc32(body_data, length) != checksum) break;
+
+                persistence_detail::Cursor body{ body_data, length };
+                std::uint64_t lsn = body.pod<std::uint64_t>();
+                Operation operation = static_cast<Operation>(body.pod<std::uint8_t>());
+                std::string first(body.string());
+                std::string second = operation != Operation::Delete ? std::string(body.string()) : std::string();
+                int file_size = operation == Operation::Insert ? body.pod<std::int32_t>() : 0;
+                if (body.failed) break;
+
+                valid_bytes += header.position + length;
+                ++log_records;
+                if (lsn <= snapshot_lsn) {
+                    ++recovery.skipped_records;
+                    continue;
+                }
+                if (operation == Operation::Insert) files.insert(first, second, file_size);
+                else if (operation == Operation::Delete) files.delete_file(first);
+                else files.rename_file(first, second);
+                next_lsn = lsn + 1;
+                ++recovery.replayed_records;
+            }
+        }
+        if (valid_bytes < file_bytes) {
+            std::filesystem::resize_file(log_path(), valid_bytes);
+            recovery.truncated_tail = true;
+        }
+    }
+
+public:
+    /**
+     * @brief Opens (or creates) the catalog stored in directory and recovers its state.
+     *
+     * @param group_size Operations per fsync. 1 makes every operation durable on return.
+     * @param snapshot_interval Log records after which a compacted snapshot is written.
+     */
+    explicit PersistentFileSystem(std::filesystem::path directory, size_t group_size = 64, size_t snapshot_interval = 1 << 16)
+        : directory(std::move(directory)), group_size(std::max<size_t>(1, group_size)),
+        snapshot_interval(std::max<size_t>(1, snapshot_interval)) {
+        std::filesystem::create_directories(this->directory);
+        Stopwatch stopwatch;
+        stopwatch.start();
+        load_snapshot();
+        replay_log();
+        stopwatch.stop();
+        recovery.seconds = stopwatch.get_elapsed_time_seconds();
+        log = std::make_unique<persistence_detail::LogWriter>(log_path(), false);
+    }
+
+    ~PersistentFileSystem() {
+        try { commit(); }
+        catch (const std::exception& e) { std::cerr << "PersistentFileSystem: " << e.what() << std::endl; }
+    }
+
+    PersistentFileSystem(const PersistentFileSystem&) = delete;
+    PersistentFileSystem& operator=(const PersistentFileSystem&) = delete;
+
+    // Only operations that change the catalog are logged; the in-memory checks (and messages)
+    // of FileSystem decide that before anything is written
+    void insert(const std::string& file_name, const std::string& file_type, int file_size) {
+        if (files.search(file_name)) {
+            files.insert(file_name, file_type, file_size); // Reports the duplicate
+            return;
+        }
+        append_record(Operation::Insert, file_name, file_type, file_size);
+        files.insert(file_name, file_type, file_size);
+        after_operation();
+    }
+
+    void delete_file(const std::string& file_name) {
+        if (!files.search(file_name)) return; // File not found
+        append_record(Operation::Delete, file_name);
+        files.delete_file(file_name);
+        after_operation();
+    }
+
+    void rename_file(const std::string& old_name, const std::string& new_name) {
+        if (!files.search(old_name) || files.search(new_name)) return;
+        append_record(Operation::Rename, old_name, new_name);
+        files.rename_file(old_name, new_name);
+        after_operation();
+    }
+
+    // Writes the pending records and waits for them to reach stable storage
+    void commit() {
+        if (pending.empty()) return;
+        log->write(pending);
+        log->sync();
+        pending.clear();
+        pending_records = 0;
+    }
+
+    // Writes a compacted snapshot of the catalog and starts a new, empty log
+    void snapshot() {
+        commit();
+
+        std::vector<SnapshotEntry> entries;
+        std::string pool;
+        entries.reserve(files.size());
+        files.for_each_inorder([&](File* file) {
+            SnapshotEntry entry{};
+            entry.name_offset = pool.size();
+            entry.name_length = static_cast<std::uint32_t>(file->file_name.size());
+            pool += file->file_name;
+            entry.type_offset = pool.size();
+            entry.type_length = static_cast<std::uint32_t>(file->file_type.size());
+            pool += file->file_type;
+            entry.file_size = file->file_size;
+            entries.push_back(entry);
+            });
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, "FSSNAP01", 8);
+        header.lsn = next_lsn - 1;
+        header.count = entries.size();
+        header.pool_offset = sizeof(header) + entries.size() * sizeof(SnapshotEntry);
+        header.pool_size = pool.size();
+
+        std::string image(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SnapshotEntry));
+        image += pool;
+        header.checksum = persistence_detail::crc32(image.data(), image.size());
+        image.insert(0, reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // Write and sync the new snapshot before it replaces the old one; a crash before the
+        // log is reset only leaves records that recovery skips by LSN
+        std::filesystem::path temporary = directory / "catalog.snapshot.tmp";
+        {
+            persistence_detail::LogWriter out(temporary, true);
+            out.write(image);
+            out.sync();
+        }
+        std::filesystem::rename(temporary, snapshot_path());
+        persistence_detail::LogWriter::sync_directory(directory);
+        snapshot_lsn = header.lsn;
+
+        log = std::make_unique<persistence_detail::LogWriter>(log_path(), true);
+        log_records = 0;
+    }
+
+    File* search(const std::string& file_name) { return files.search(file_name); }
+    std::vector<File*> search_by_size(int threshold) { return files.search_by_size(threshold); }
+    std::vector<File*> inorder() { return files.inorder(); }
+
+    // Read access to the recovered tree; all changes must go through this class to be logged
+    const FileSystem& catalog() const { return files; }
+
+    size_t size() const { return files.size(); }
+    std::uint64_t last_lsn() const { return next_lsn - 1; }
+    const RecoveryStats& recovery_stats() const { return recovery; }
+};
+
+#endif // PERSISTENT_FILE_SYSTEM_HPP
@@ -0,0 +1,241 @@
+#ifndef SIZE_INDEX_HPP
+#define SIZE_INDEX_HPP
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "file.hpp"
+
+// Order-statistic AVL tree over the files of a FileSystem, ordered by (file_size, file_name).
+// Every node also stores the number of files in its subtree, which makes counting the files
+// above a size O(log n) and listing them O(log n + k).
+//
+// The index points at the FileSystem's File nodes and reads their size and name as the key, so
+// a file must be erased from the index before its size or name changes or it is deleted.
+class SizeIndex {
+    struct Node {
+        File* file;
+        Node* left;
+        Node* right;
+        int height;
+        size_t count; // Files in this subtree
+
+        Node(File* f) : file(f), left(nullptr), right(nullptr), height(1), count(1) {}
+    };
+
+    Node* root;
+
+private:
+    static bool key_less(const File* a, const File* b) {
+        if (a->file_size != b->file_size) return a->file_size < b->file_size;
+        return a->file_name < b->file_name;
+    }
+
+    static int height(Node* node) { return node ? node->height : 0; }
+    static size_t count(Node* node) { return node ? node->count : 0; }
+
+    static void update(Node* node) {
+        node->height = 1 + std::max(height(node->left), height(node->right));
+        node->count = 1 + count(node->left) + count(node->right);
+    }
+
+    static int balance_factor(Node* node) { return height(node->left) - height(node->right); }
+
+    static void rotate_right(Node*& link) {
+        Node* node = link;
+        Node* pivot = node->left;
+        node->left = pivot->right;
+        pivot->right = node;
+        update(node);
+        update(pivot);
+        link = pivot;
+    }
+
+    static void rotate_left(Node*& link) {
+        Node* node = link;
+        Node* pivot = node->right;
+        node->right = pivot->left;
+        pivot->left = node;
+        update(node);
+        update(pivot);
+        link = pivot;
+    }
+
+    static void rebalance(Node*& link) {
+        Node* node = link;
+        update(node);
+        int balance = balance_factor(node);
+        if (balance > 1) {
+            if (balance_factor(node->left) < 0) rotate_left(node->left);
+            rotate_right(link);
+        }
+        else if (balance < -1) {
+            if (balance_factor(node->right) > 0) rotate_right(node->right);
+            rotate_left(link);
+        }
+    }
+
+    static void rebalance_path(std::vector<Node**>& path) {
+        for (size_t i = path.size(); i-- > 0;)
+            if (*path[i]) rebalance(*path[i]);
+    }
+
+public:
+    SizeIndex() : root(nullptr) {}
+    ~SizeIndex() { clear(); }
+
+    SizeIndex(const SizeIndex&) = delete;
+    SizeIndex& operator=(const SizeIndex&) = delete;
+
+    void insert(File* file) {
+        std::vector<Node**> path;
+        Node** link = &root;
+        while (*link) {
+            path.push_back(link);
+            link = key_less(file, (*link)->file) ? &(*link)->left : &(*link)->right;
+        }
+        *link = new Node(file);
+        rebalance_path(path);
+    }
+
+    void erase(File* file) {
+        std::vector<Node**> path;
+        Node** link = &root;
+        while (*link && (*link)->file != file) {
+            path.push_back(link);
+            link = key_less(file, (*link)->file) ? &(*link)->left : &(*link)->right;
+        }
+        if (!*link) return;
+
+        Node* node = *link;
+        if (!node->left || !node->right) {
+            *link = node->left ? node->left : node->right;
+            delete node;
+        }
+        else {
+            // Keep the node, take over its in-order successor's file and unlink the successor
+            path.push_back(link);
+            Node** successor_link = &node->right;
+            while ((*successor_link)->left) {
+                path.push_back(successor_link);
+                successor_link = &(*successor_link)->left;
+            }
+            Node* successor = *successor_link;
+            node->file = successor->file;
+            *successor_link = successor->right;
+            path.push_back(successor_link);
+            delete successor;
+        }
+        rebalance_path(path);
+    }
+
+    /**
+     * @brief Drops the entries whose file fails keep(file) and adds files, in one pass.
+     *
+     * The added files are sorted, merged with the in-order sequence of the kept nodes and
+     * the tree is relinked balanced: O(n + m log m) instead of one O(log n) update per file.
+     * A range of c nodes gets height floor(log2 c) + 1 and count c without visiting children.
+     */
+    template <typename Keep>
+    void rebuild(std::vector<File*> files, Keep keep) {
+        std::sort(files.begin(), files.end(), key_less);
+        std::vector<Node*> nodes, stack;
+        nodes.reserve(size() + files.size());
+        size_t f = 0;
+        Node* node = root;
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            Node* right = node->right;
+            if (!keep(node->file)) delete node;
+            else {
+                for (; f < files.size() && key_less(files[f], node->file); ++f) nodes.push_back(new Node(files[f]));
+                nodes.push_back(node);
+            }
+            node = right;
+        }
+        for (; f < files.size(); ++f) nodes.push_back(new Node(files[f]));
+
+        struct Range { size_t lo, hi; Node** link; };
+        std::vector<Range> ranges{ { 0, nodes.size(), &root } };
+        while (!ranges.empty()) {
+            Range range = ranges.back();
+            ranges.pop_back();
+            if (range.lo == range.hi) {
+                *range.link = nullptr;
+                continue;
+            }
+            size_t mid = range.lo + (range.hi - range.lo) / 2;
+            Node* middle = nodes[mid];
+            middle->count = range.hi - range.lo;
+            middle->height = 1;
+            for (size_t c = middle->count; c > 1; c /= 2) ++middle->height;
+            *range.link = middle;
+            ranges.push_back({ range.lo, mid, &middle->left });
+            ranges.push_back({ mid + 1, range.hi, &middle->right });
+        }
+    }
+
+    void clear() {
+        std::vector<Node*> stack;
+        if (root) stack.push_back(root);
+        while (!stack.empty()) {
+            Node* node = stack.back();
+            stack.pop_back();
+            if (node->left) stack.push_back(node->left);
+            if (node->right) stack.push_back(node->right);
+            delete node;
+        }
+        root = nullptr;
+    }
+
+    // Number of files with file_size > threshold, O(log n)
+    size_t count_larger_than(int threshold) const {
+        size_t result = 0;
+        Node* node = root;
+        while (node) {
+            if (node->file->file_size > threshold) {
+                result += 1 + count(node->right);
+                node = node->left;
+            }
+            else node = node->right;
+        }
+        return result;
+    }
+
+    // Visits the files with file_size > threshold in ascending size order, O(log n + k) for the k
+    // files visited before the visitor stops; returns false if it stopped early
+    template <typename Visitor>
+    bool for_each_larger_than(int threshold, Visitor visitor) const {
+        std::vector<Node*> stack;
+        Node* node = root;
+        // Stack the path to the first qualifying file: every node kept is larger than threshold
+        while (node) {
+            if (node->file->file_size > threshold) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            else node = node->right;
+        }
+        while (!stack.empty()) {
+            node = stack.back();
+            stack.pop_back();
+            if (!visit_file(visitor, node->file)) return false;
+            for (Node* next = node->right; next; next = next->left) stack.push_back(next);
+        }
+        return true;
+    }
+
+    void collect_larger_than(int threshold, std::vector<File*>& result) const {
+        for_each_larger_than(threshold, [&](File* file) { result.push_back(file); });
+    }
+
+    size_t size() const { return count(root); }
+};
+
+#endif // SIZE_INDEX_HPP
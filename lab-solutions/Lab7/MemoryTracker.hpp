@@ -3,18 +3,20 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <atomic>
 
 class MemoryTracker {
 public:
     /**
-     * @brief Tracks the total memory allocated and deallocated by the program.
+     * @brief Tracks the total memory allocated by the program.
+     * @note Atomic, so allocations from several threads are all counted.
      */
-    static inline size_t allocatedMemory = 0;
+    static inline std::atomic<size_t> allocatedMemory{ 0 };
 
     /**
      * @brief Tracks the total memory deallocated by the program.
      */
-    static inline size_t deallocatedMemory = 0;
+    static inline std::atomic<size_t> deallocatedMemory{ 0 };
 
     /**
      * @brief Reports the memory allocated and deallocated by the program.
@@ -45,20 +47,20 @@ public:
 
 // Overload the new operator to log memory allocation for single objects
 void* operator new(size_t size) {
-    MemoryTracker::allocatedMemory += size;
+    MemoryTracker::allocatedMemory.fetch_add(size, std::memory_order_relaxed);
     return malloc(size);
 }
 
 // Overload the new[] operator to log memory allocation for arrays
 void* operator new[](size_t size) {
-    MemoryTracker::allocatedMemory += size;
+    MemoryTracker::allocatedMemory.fetch_add(size, std::memory_order_relaxed);
     return malloc(size);
 }
 
 // Overload the delete operator to log memory deallocation for single objects
 void operator delete(void* memory, size_t size) noexcept {
     if (!memory) return;
-    MemoryTracker::deallocatedMemory += size;
+    MemoryTracker::deallocatedMemory.fetch_add(size, std::memory_order_relaxed);
     free(memory);
 }
 
@@ -66,7 +68,7 @@ void operator delete(void* memory, size_t size) noexcept {
 void operator delete[](void* memory) noexcept {
     if (!memory) return;
     size_t size = GET_ALLOCATED_SIZE(memory);
-    MemoryTracker::deallocatedMemory += size;
+    MemoryTracker::deallocatedMemory.fetch_add(size, std::memory_order_relaxed);
     free(memory);
 }
 
@@ -0,0 +1,103 @@
+// Per-element cost of OperationChain::apply called once per element against applyBatch over
+// the whole array, on one thread and split over several, for two chains of floats: six
+// Add/Multiply steps, and Task2's operations up to CachedAdd. Every variant gets its own
+// operations, so the cached ones see the same inputs; the largest relative difference to the
+// per-element results is reported (the threaded CachedAdd regroups its sums).
+//
+// Usage: batch_benchmark [elements] [repeats] [threads]
+
+#include<iostream>
+#include<iomanip>
+#include<random>
+#include<string>
+#include<vector>
+#include<algorithm>
+#include<cmath>
+#include<thread>
+
+#include "../operation_chain.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+template<typename Run>
+double per_element_ns(size_t elements, size_t repeats, Run run) {
+    double best = 1e30;
+    for (size_t r = 0; r < repeats; ++r) { // The VM is noisy: keep the fastest pass
+        Stopwatch stopwatch;
+        stopwatch.start();
+        run();
+        stopwatch.stop();
+        best = std::min(best, stopwatch.get_elapsed_time_seconds());
+    }
+    return best * 1e9 / elements;
+}
+
+double max_difference(const std::vector<float>& expected, const std::vector<float>& actual) {
+    double worst = 0;
+    for (size_t i = 0; i < expected.size(); ++i)
+        worst = std::max(worst, std::abs(static_cast<double>(actual[i]) - expected[i]) / std::max(1.0, std::abs(static_cast<double>(expected[i]))));
+    return worst;
+}
+
+void report(const std::string& name, double ns, double baseline_ns, double difference) {
+    std::cout << "  " << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(2)
+        << std::setw(8) << ns << " ns" << std::setw(8) << std::setprecision(1) << baseline_ns / ns << "x"
+        << std::setw(14) << std::scientific << std::setprecision(1) << difference << std::defaultfloat << std::endl;
+}
+
+void affine_chain(OperationChain<float>& chain) {
+    chain.addOperation(new Add<float>(1));
+    chain.addOperation(new Multiply<float>(1.5f));
+    chain.addOperation(new Add<float>(-1));
+    chain.addOperation(new Multiply<float>(0.75f));
+    chain.addOperation(new Add<float>(3));
+    chain.addOperation(new Multiply<float>(0.5f));
+}
+
+void task2_chain(OperationChain<float>& chain) {
+    chain.addOperation(new Add<float>(5));
+    chain.addOperation(new Multiply<float>(2));
+    chain.addOperation(new Power<float>(3));
+    chain.addOperation(new CachedSine<float>());
+    chain.addOperation(new CachedAdd<float>());
+}
+
+template<typename Build>
+void run(const std::string& title, Build build, const std::vector<float>& input, size_t repeats, unsigned threads) {
+    std::vector<float> expected(input.size()), output(input.size());
+    std::cout << title << std::endl;
+
+    // The cached operations keep changing over the timed passes, so results are compared on
+    // every variant's first pass
+    OperationChain<float> linked;
+    build(linked);
+    for (size_t i = 0; i < input.size(); ++i) expected[i] = linked.apply(input[i], false);
+    double baseline = per_element_ns(input.size(), repeats, [&]() {
+        for (size_t i = 0; i < input.size(); ++i) output[i] = linked.apply(input[i], false);
+        });
+    report("OperationChain::apply", baseline, baseline, 0.0);
+
+    for (unsigned t = 1; t <= threads; t *= 2) {
+        OperationChain<float> batch;
+        build(batch);
+        batch.applyBatch(input.data(), output.data(), input.size(), t);
+        double difference = max_difference(expected, output);
+        report("applyBatch, " + std::to_string(t) + " thread(s)",
+            per_element_ns(input.size(), repeats, [&]() { batch.applyBatch(input.data(), output.data(), input.size(), t); }), baseline, difference);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t elements = argc > 1 ? std::stoul(argv[1]) : 4000000;
+    const size_t repeats = argc > 2 ? std::stoul(argv[2]) : 5;
+    const unsigned threads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> uniform(-2.0f, 2.0f);
+    std::vector<float> input(elements);
+    for (float& x : input) x = uniform(rng);
+
+    std::cout << "Per element, best of " << repeats << "; speed-up over apply; largest relative difference" << std::endl;
+    run("Add/Multiply x3", affine_chain, input, repeats, threads);
+    run("Task2 chain up to CachedAdd", task2_chain, input, repeats, threads);
+    return 0;
+}
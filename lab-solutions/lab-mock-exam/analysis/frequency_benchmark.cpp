@@ -0,0 +1,128 @@
+// Frequency queries on a live corpus: words keep arriving (Zipf-distributed over a fixed
+// vocabulary) and after every batch the corpus is asked for its top 10, bottom 10, most
+// frequent and longest words. The frequency buckets answer from their ends; the baseline does
+// what the queries did before, a full traversal (and sort, for top/bottom k) per query.
+//
+// Usage: frequency_benchmark [vocabulary size] [batches] [words per batch]
+
+#include<iostream>
+#include<iomanip>
+#include<random>
+#include<string>
+#include<vector>
+#include<algorithm>
+#include<cmath>
+
+#include "../word_data.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+// The previous implementations, on top of the public traversal
+std::vector<std::string> sorted_k(const WordData& wordData, int k, bool descending) {
+    std::vector<Word> words;
+    wordData.preOrder([&](const Word& word) { words.push_back(word); });
+    std::sort(words.begin(), words.end(), [&](const Word& a, const Word& b) {
+        return descending ? a.frequency > b.frequency : a.frequency < b.frequency;
+        });
+    std::vector<std::string> result;
+    for (int i = 0; i < k && i < static_cast<int>(words.size()); ++i) result.push_back(words[i].word);
+    return result;
+}
+
+std::vector<std::string> scan_most_frequent(const WordData& wordData) {
+    std::vector<std::string> result;
+    int maxFrequency = 0;
+    wordData.preOrder([&](const Word& word) {
+        if (word.frequency > maxFrequency) {
+            maxFrequency = word.frequency;
+            result.assign(1, word.word);
+        }
+        else if (word.frequency == maxFrequency) result.push_back(word.word);
+        });
+    return result;
+}
+
+std::vector<std::string> scan_longest(const WordData& wordData) {
+    std::vector<std::string> result;
+    size_t maxLength = 0;
+    wordData.preOrder([&](const Word& word) {
+        if (word.word.length() > maxLength) {
+            maxLength = word.word.length();
+            result.assign(1, word.word);
+        }
+        else if (word.word.length() == maxLength) result.push_back(word.word);
+        });
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t vocabulary = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t batches = argc > 2 ? std::stoul(argv[2]) : 50;
+    const size_t batch_size = argc > 3 ? std::stoul(argv[3]) : 20000;
+
+    std::mt19937 rng(42);
+    std::vector<std::string> words;
+    for (size_t i = 0; i < vocabulary; ++i) {
+        std::string word;
+        size_t length = 2 + rng() % 12;
+        for (size_t j = 0; j < length; ++j) word += static_cast<char>('a' + rng() % 26);
+        words.push_back(word);
+    }
+    // Zipf(1) ranks by inverse transform over the harmonic weights
+    std::vector<double> cumulative(vocabulary);
+    double sum = 0;
+    for (size_t i = 0; i < vocabulary; ++i) cumulative[i] = sum += 1.0 / (i + 1);
+    std::uniform_real_distribution<double> uniform(0.0, sum);
+
+    WordData wordData;
+    Stopwatch stopwatch;
+    double insert_seconds = 0, bucket_seconds = 0, scan_seconds = 0;
+    size_t checked = 0, agree = 0;
+    for (size_t b = 0; b < batches; ++b) {
+        stopwatch.reset();
+        stopwatch.start();
+        for (size_t i = 0; i < batch_size; ++i) {
+            size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin();
+            wordData.insert(Word(words[std::min(rank, vocabulary - 1)], 1));
+        }
+        stopwatch.stop();
+        insert_seconds += stopwatch.get_elapsed_time_seconds();
+
+        stopwatch.reset();
+        stopwatch.start();
+        auto top = wordData.top_k(10);
+        auto bottom = wordData.bottom_k(10);
+        auto most = wordData.most_frequent();
+        auto longest = wordData.longest_word();
+        stopwatch.stop();
+        bucket_seconds += stopwatch.get_elapsed_time_seconds();
+
+        stopwatch.reset();
+        stopwatch.start();
+        auto top_scan = sorted_k(wordData, 10, true);
+        auto bottom_scan = sorted_k(wordData, 10, false);
+        auto most_scan = scan_most_frequent(wordData);
+        auto longest_scan = scan_longest(wordData);
+        stopwatch.stop();
+        scan_seconds += stopwatch.get_elapsed_time_seconds();
+
+        // Ties may come in a different order, so compare frequencies and sets
+        auto frequencies = [&](const std::vector<std::string>& list) {
+            std::vector<int> result;
+            for (const auto& word : list) result.push_back(wordData.getFrequency(word));
+            return result;
+        };
+        auto sorted = [](std::vector<std::string> list) { std::sort(list.begin(), list.end()); return list; };
+        ++checked;
+        agree += frequencies(top) == frequencies(top_scan) && frequencies(bottom) == frequencies(bottom_scan)
+            && sorted(most) == sorted(most_scan) && sorted(longest) == sorted(longest_scan);
+    }
+
+    std::cout << "Unique words: " << wordData.getUniqueWordCount() << ", total: " << wordData.getTotalWordCount()
+        << ", batches: " << batches << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Inserts (tree, radix index, buckets): " << insert_seconds / (batches * batch_size) * 1e9 << " ns/word" << std::endl;
+    std::cout << "Queries per batch, buckets:            " << bucket_seconds / batches * 1e3 << " ms" << std::endl;
+    std::cout << "Queries per batch, traverse and sort:  " << scan_seconds / batches * 1e3 << " ms" << std::endl;
+    std::cout << (agree == checked ? "Results agree" : "MISMATCH") << std::endl;
+    return 0;
+}
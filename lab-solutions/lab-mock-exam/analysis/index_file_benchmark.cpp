@@ -0,0 +1,115 @@
+// Reopening a word table: WordData::openIndex (map the binary index, nothing parsed) against
+// rebuilding the tree from the exportToFile text table. Both files are written from the same
+// WordData of random words with Zipf-like frequencies; the program reports their sizes, the
+// time to the first answer, the lookup and prefix query rates of the mapped and the in-memory
+// word data, and whether both answer alike.
+//
+// Usage: index_file_benchmark [unique words] [lookups]
+
+#include<iostream>
+#include<iomanip>
+#include<fstream>
+#include<sstream>
+#include<random>
+#include<string>
+#include<vector>
+#include<set>
+#include<filesystem>
+
+#include "../word_data.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+// The way back from exportToFile: parse every line and rebuild the tree
+void load_text_table(WordData& wordData, const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) throw std::runtime_error("Could not open file: " + path);
+    std::vector<Word> words;
+    std::string word;
+    int frequency;
+    while (in >> word >> frequency) words.emplace_back(word, frequency);
+    wordData.insertSorted(words);
+}
+
+int main(int argc, char* argv[]) {
+    const size_t unique = argc > 1 ? std::stoul(argv[1]) : 500000;
+    const size_t lookups = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    const std::string text_path = "index_benchmark_table.txt", index_path = "index_benchmark_table.idx";
+
+    std::mt19937 rng(42);
+    std::set<std::string> vocabulary;
+    while (vocabulary.size() < unique) {
+        std::string word;
+        size_t length = 3 + rng() % 10;
+        for (size_t j = 0; j < length; ++j) word += static_cast<char>('a' + rng() % 26);
+        vocabulary.insert(word);
+    }
+    std::vector<Word> words;
+    size_t rank = 0;
+    for (const auto& word : vocabulary) words.emplace_back(word, static_cast<int>(1000000 / (1 + (++rank * 7919) % unique)) + 1);
+
+    WordData source;
+    source.insertSorted(words);
+    source.exportToFile(text_path);
+    source.exportIndex(index_path);
+
+    std::vector<std::string> probes, prefixes;
+    for (size_t i = 0; i < lookups; ++i) {
+        const std::string& word = words[rng() % words.size()].word;
+        probes.push_back(i % 4 == 0 ? word + "q" : word); // A quarter misses
+        prefixes.push_back(word.substr(0, 3));
+    }
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+    WordData loaded;
+    load_text_table(loaded, text_path);
+    int first_loaded = loaded.getFrequency(probes[0]);
+    stopwatch.stop();
+    const double load_seconds = stopwatch.get_elapsed_time_seconds();
+
+    stopwatch.reset();
+    stopwatch.start();
+    WordData mapped = WordData::openIndex(index_path);
+    int first_mapped = mapped.getFrequency(probes[0]);
+    stopwatch.stop();
+    const double open_seconds = stopwatch.get_elapsed_time_seconds();
+
+    auto lookup_rate = [&](const WordData& wordData, long long& sum) {
+        Stopwatch watch;
+        watch.start();
+        for (const auto& probe : probes) sum += wordData.getFrequency(probe);
+        watch.stop();
+        return probes.size() / watch.get_elapsed_time_seconds();
+    };
+    auto prefix_rate = [&](const WordData& wordData, size_t& matches) {
+        const size_t count = std::min<size_t>(prefixes.size(), 20000);
+        Stopwatch watch;
+        watch.start();
+        for (size_t i = 0; i < count; ++i) matches += wordData.starts_with(prefixes[i]).size();
+        watch.stop();
+        return count / watch.get_elapsed_time_seconds();
+    };
+    long long loaded_sum = 0, mapped_sum = 0;
+    size_t loaded_matches = 0, mapped_matches = 0;
+    const double loaded_lookups = lookup_rate(loaded, loaded_sum), mapped_lookups = lookup_rate(mapped, mapped_sum);
+    const double loaded_prefixes = prefix_rate(loaded, loaded_matches), mapped_prefixes = prefix_rate(mapped, mapped_matches);
+
+    bool same = first_loaded == first_mapped && loaded_sum == mapped_sum && loaded_matches == mapped_matches
+        && loaded.getTotalWordCount() == mapped.getTotalWordCount() && loaded.top_k(20) == mapped.top_k(20)
+        && loaded.bottom_k(20) == mapped.bottom_k(20) && loaded.longest_word() == mapped.longest_word();
+
+    std::cout << "Unique words: " << unique << ", total: " << source.getTotalWordCount() << std::endl;
+    std::cout << "Text table:  " << std::filesystem::file_size(text_path) / 1024 << " KB" << std::endl;
+    std::cout << "Index file:  " << std::filesystem::file_size(index_path) / 1024 << " KB" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "To first answer, parse text table and build: " << load_seconds * 1e3 << " ms" << std::endl;
+    std::cout << "To first answer, openIndex:                  " << open_seconds * 1e6 << " us" << std::endl;
+    std::cout << std::setprecision(0);
+    std::cout << "getFrequency/s, in memory: " << loaded_lookups << ", mapped: " << mapped_lookups << std::endl;
+    std::cout << "starts_with/s,  in memory: " << loaded_prefixes << ", mapped: " << mapped_prefixes << std::endl;
+    std::cout << (same ? "Results agree" : "MISMATCH") << std::endl;
+
+    std::filesystem::remove(text_path);
+    std::filesystem::remove(index_path);
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Compares the WordData(path) constructor with the parallel, memory-mapped
+// ingestCorpus on a corpus built by repeating data/small-text.txt (with numbered variants of
+// some words so that the vocabulary keeps growing), checks that both count the same words and
+// reports throughput in GB/s.
+//
+// Usage: ingest_benchmark [corpus size in MB] [corpus path]
+
+#include<iostream>
+#include<iomanip>
+#include<fstream>
+#include<sstream>
+#include<string>
+#include<vector>
+#include<thread>
+#include<filesystem>
+
+#include "../word_data.hpp"
+#include "../corpus_ingest.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+void generate_corpus(const std::string& source, const std::string& path, size_t size_mb) {
+    std::ifstream in(source);
+    if (!in.is_open()) throw std::runtime_error("Could not open file: " + source);
+    std::stringstream text;
+    text << in.rdbuf();
+    std::vector<std::string> tokens;
+    std::string token;
+    while (text >> token) tokens.push_back(token);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    size_t written = 0, round = 0;
+    const std::string letters = "abcdefghijklmnopqrstuvwxyz";
+    while (written < (size_mb << 20)) {
+        std::string block;
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            block += tokens[i];
+            // Every seventh token gets a suffix that spells the round number in letters
+            if (i % 7 == 0) for (size_t r = round; r > 0; r /= 26) block += letters[r % 26];
+            block += (i % 12 == 11) ? '\n' : ' ';
+        }
+        out << block;
+        written += block.size();
+        ++round;
+    }
+}
+
+std::vector<std::pair<std::string, int>> contents(const WordData& wordData) {
+    std::vector<std::pair<std::string, int>> result;
+    wordData.inOrder([&](const Word& word) { result.emplace_back(word.word, word.frequency); });
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t size_mb = argc > 1 ? std::stoul(argv[1]) : 256;
+    const std::string path = argc > 2 ? argv[2] : "ingest_corpus.txt";
+    generate_corpus("data/small-text.txt", path, size_mb);
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+    WordData legacy(path);
+    stopwatch.stop();
+    double legacy_seconds = stopwatch.get_elapsed_time_seconds();
+    const double gigabytes = static_cast<double>(std::filesystem::file_size(path)) / 1e9;
+
+    std::cout << "Corpus: " << std::fixed << std::setprecision(2) << gigabytes << " GB, "
+        << legacy.getTotalWordCount() << " words, " << legacy.getUniqueWordCount() << " unique" << std::endl;
+    std::cout << std::left << std::setw(22) << "Method" << std::right << std::setw(10) << "Seconds" << std::setw(10) << "GB/s"
+        << std::setw(10) << "Count" << std::setw(10) << "Merge" << std::setw(10) << "Insert" << std::endl;
+    std::cout << std::left << std::setw(22) << "WordData(path)" << std::right << std::setprecision(3)
+        << std::setw(10) << legacy_seconds << std::setw(10) << gigabytes / legacy_seconds << std::endl;
+
+    const auto expected = contents(legacy);
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= cores; threads *= 2) {
+        WordData wordData;
+        IngestStats stats = ingestCorpus(wordData, path, threads);
+        std::cout << std::left << std::setw(22) << ("ingestCorpus x" + std::to_string(stats.threads)) << std::right
+            << std::setw(10) << stats.totalSeconds() << std::setw(10) << stats.gigabytesPerSecond()
+            << std::setw(10) << stats.countSeconds << std::setw(10) << stats.mergeSeconds << std::setw(10) << stats.insertSeconds;
+        bool same = contents(wordData) == expected && wordData.getTotalWordCount() == legacy.getTotalWordCount();
+        std::cout << (same ? "" : "   MISMATCH") << std::endl;
+        if (threads < cores && threads * 2 > cores) threads = cores / 2; // Also measure all cores
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Bigram, trigram and co-occurrence (window 5) counting on a corpus built by repeating
+// data/small-text.txt with numbered variants of some words. NgramStats, exact and in sketch
+// mode, against the straightforward version: one thread and hash maps keyed by the words
+// joined with spaces. Reports build times, the top-successor query rate, and for the sketch
+// the mean overestimate of the 1000 most frequent bigrams.
+//
+// Usage: ngram_benchmark [corpus size in MB] [threads]
+
+#include<iostream>
+#include<iomanip>
+#include<fstream>
+#include<sstream>
+#include<string>
+#include<vector>
+#include<unordered_map>
+#include<algorithm>
+#include<filesystem>
+
+#include "../ngram_stats.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+void generate_corpus(const std::string& source, const std::string& path, size_t size_mb) {
+    std::ifstream in(source);
+    if (!in.is_open()) throw std::runtime_error("Could not open file: " + source);
+    std::stringstream text;
+    text << in.rdbuf();
+    std::vector<std::string> tokens;
+    std::string token;
+    while (text >> token) tokens.push_back(token);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    size_t written = 0, round = 0;
+    while (written < (size_mb << 20)) {
+        std::string block;
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            block += tokens[i];
+            // Every seventh token gets a suffix from the round number, cycling through 200 variants
+            if (i % 7 == 0) for (size_t r = round % 200; r > 0; r /= 26) block += static_cast<char>('a' + r % 26);
+            block += (i % 12 == 11) ? '\n' : ' ';
+        }
+        out << block;
+        written += block.size();
+        ++round;
+    }
+}
+
+struct StringCounts {
+    std::unordered_map<std::string, long long> bigrams, trigrams, cooccurrences;
+};
+
+// One thread, one string per key
+StringCounts count_with_strings(const std::string& path, unsigned window) {
+    std::ifstream in(path);
+    StringCounts counts;
+    std::vector<std::string> recent;
+    std::string token;
+    while (in >> token) {
+        std::string word = WordData::normalize(token);
+        if (word.empty()) continue;
+        const size_t n = recent.size();
+        if (n >= 1) ++counts.bigrams[recent[n - 1] + ' ' + word];
+        if (n >= 2) ++counts.trigrams[recent[n - 2] + ' ' + recent[n - 1] + ' ' + word];
+        for (size_t back = 1; back <= window && back <= n; ++back) {
+            const std::string& other = recent[n - back];
+            if (other != word) ++counts.cooccurrences[std::min(other, word) + ' ' + std::max(other, word)];
+        }
+        recent.push_back(word);
+        if (recent.size() > window) recent.erase(recent.begin());
+    }
+    return counts;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t size_mb = argc > 1 ? std::stoul(argv[1]) : 64;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : std::max(1u, std::thread::hardware_concurrency());
+    const std::string path = "ngram_corpus.txt";
+    generate_corpus("data/small-text.txt", path, size_mb);
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+    StringCounts strings = count_with_strings(path, 5);
+    stopwatch.stop();
+    const double string_seconds = stopwatch.get_elapsed_time_seconds();
+
+    NgramOptions exact_options;
+    exact_options.threads = threads;
+    stopwatch.reset();
+    stopwatch.start();
+    NgramStats exact(path, exact_options);
+    stopwatch.stop();
+    const double exact_seconds = stopwatch.get_elapsed_time_seconds();
+
+    NgramOptions sketch_options = exact_options;
+    sketch_options.sketch = true;
+    stopwatch.reset();
+    stopwatch.start();
+    NgramStats sketch(path, sketch_options);
+    stopwatch.stop();
+    const double sketch_seconds = stopwatch.get_elapsed_time_seconds();
+
+    // Every count of the string maps must match the exact engine
+    bool same = true;
+    for (const auto& [key, count] : strings.bigrams) {
+        size_t space = key.find(' ');
+        same = same && exact.count(key.substr(0, space), key.substr(space + 1)) == count;
+    }
+    for (const auto& [key, count] : strings.cooccurrences) {
+        size_t space = key.find(' ');
+        same = same && exact.cooccurrences(key.substr(0, space), key.substr(space + 1)) == count;
+    }
+    for (const auto& [key, count] : strings.trigrams) {
+        size_t first = key.find(' '), second = key.find(' ', first + 1);
+        same = same && exact.count(key.substr(0, first), key.substr(first + 1, second - first - 1), key.substr(second + 1)) == count;
+    }
+
+    std::vector<std::pair<long long, std::string>> heaviest;
+    for (const auto& [key, count] : strings.bigrams) heaviest.emplace_back(count, key);
+    const size_t checked = std::min<size_t>(1000, heaviest.size());
+    std::partial_sort(heaviest.begin(), heaviest.begin() + checked, heaviest.end(), std::greater<>());
+    double overestimate = 0;
+    for (size_t i = 0; i < checked; ++i) {
+        size_t space = heaviest[i].second.find(' ');
+        long long estimate = sketch.count(heaviest[i].second.substr(0, space), heaviest[i].second.substr(space + 1));
+        overestimate += static_cast<double>(estimate - heaviest[i].first) / heaviest[i].first;
+    }
+
+    std::vector<std::string> probes;
+    for (size_t i = 0; i < checked; ++i) probes.push_back(heaviest[i].second.substr(0, heaviest[i].second.find(' ')));
+    size_t answers = 0;
+    stopwatch.reset();
+    stopwatch.start();
+    for (int repeat = 0; repeat < 100; ++repeat)
+        for (const auto& probe : probes) answers += exact.topSuccessors(probe, 10).size();
+    stopwatch.stop();
+    const double query_seconds = stopwatch.get_elapsed_time_seconds() / (100.0 * probes.size());
+
+    std::cout << "Corpus: " << size_mb << " MB, " << exact.vocabularySize() << " distinct words, "
+        << strings.bigrams.size() << " bigrams, " << strings.trigrams.size() << " trigrams, "
+        << strings.cooccurrences.size() << " co-occurring pairs" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "String keys, 1 thread:            " << string_seconds << " s" << std::endl;
+    std::cout << "NgramStats exact, " << threads << " thread(s):     " << exact_seconds << " s" << std::endl;
+    std::cout << "NgramStats sketch, " << threads << " thread(s):    " << sketch_seconds << " s" << std::endl;
+    std::cout << "topSuccessors(word, 10):          " << query_seconds * 1e6 << " us (" << answers / (100 * probes.size()) << " words)" << std::endl;
+    std::cout << "Sketch overestimate, top " << checked << ":   " << std::setprecision(2) << overestimate / checked * 100 << " %" << std::endl;
+    std::cout << (same ? "Exact counts agree" : "MISMATCH") << std::endl;
+
+    std::filesystem::remove(path);
+    return 0;
+}
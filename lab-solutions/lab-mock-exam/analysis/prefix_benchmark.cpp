@@ -0,0 +1,91 @@
+// Prefix queries on WordData: the pruned BST walk (for_each_starting_with) against the radix
+// index behind starts_with, and top-k autocomplete by filtering and sorting every completion
+// against the radix index's best-first top_k_starting_with. The words are random letter
+// strings with Zipf-like frequencies.
+//
+// Usage: prefix_benchmark [unique words] [queries]
+
+#include<iostream>
+#include<iomanip>
+#include<random>
+#include<string>
+#include<vector>
+#include<algorithm>
+
+#include "../word_data.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+int main(int argc, char* argv[]) {
+    const size_t n = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t queries = argc > 2 ? std::stoul(argv[2]) : 20000;
+
+    std::mt19937 rng(42);
+    std::vector<Word> words;
+    for (size_t i = 0; i < n; ++i) {
+        std::string word;
+        size_t length = 3 + rng() % 8;
+        for (size_t j = 0; j < length; ++j) word += static_cast<char>('a' + rng() % 26);
+        words.emplace_back(word, static_cast<int>(1000000 / (i + 1)) + 1);
+    }
+    std::shuffle(words.begin(), words.end(), rng); // Random insertion order keeps the BST shallow
+    WordData wordData;
+    for (const Word& word : words) wordData.insert(word);
+
+    std::cout << "Words: " << wordData.getUniqueWordCount() << ", queries per row: " << queries << std::endl;
+    std::cout << std::left << std::setw(8) << "Prefix" << std::setw(26) << "Query" << std::right
+        << std::setw(12) << "BST us" << std::setw(12) << "Radix us" << std::setw(12) << "Matches" << std::endl;
+
+    Stopwatch stopwatch;
+    for (size_t length = 1; length <= 3; ++length) {
+        std::vector<std::string> prefixes;
+        for (size_t q = 0; q < queries; ++q) {
+            std::string prefix;
+            for (size_t j = 0; j < length; ++j) prefix += static_cast<char>('a' + rng() % 26);
+            prefixes.push_back(prefix);
+        }
+        // Fewer queries for the one-letter prefixes, which match about n / 26 words each
+        const size_t count = length == 1 ? queries / 100 : queries;
+
+        size_t bst_matches = 0, radix_matches = 0;
+        stopwatch.reset();
+        stopwatch.start();
+        for (size_t q = 0; q < count; ++q) {
+            std::vector<std::string> result;
+            wordData.for_each_starting_with(prefixes[q], [&](const Word& word) { result.push_back(word.word); });
+            bst_matches += result.size();
+        }
+        stopwatch.stop();
+        double bst = stopwatch.get_elapsed_time_seconds() * 1e6 / count;
+        stopwatch.reset();
+        stopwatch.start();
+        for (size_t q = 0; q < count; ++q) radix_matches += wordData.starts_with(prefixes[q]).size();
+        stopwatch.stop();
+        double radix = stopwatch.get_elapsed_time_seconds() * 1e6 / count;
+        std::cout << std::left << std::setw(8) << length << std::setw(26) << "starts_with" << std::right << std::fixed
+            << std::setprecision(2) << std::setw(12) << bst << std::setw(12) << radix << std::setw(12) << bst_matches / count
+            << (bst_matches == radix_matches ? "" : "   MISMATCH") << std::endl;
+
+        // Top 10 by frequency: every completion sorted, against the best-first search
+        size_t agree = 0;
+        std::vector<std::vector<std::string>> sorted(count);
+        stopwatch.reset();
+        stopwatch.start();
+        for (size_t q = 0; q < count; ++q) {
+            std::vector<Word> completions;
+            wordData.for_each_starting_with(prefixes[q], [&](const Word& word) { completions.push_back(word); });
+            std::stable_sort(completions.begin(), completions.end(), [](const Word& a, const Word& b) { return a.frequency > b.frequency; });
+            for (size_t i = 0; i < 10 && i < completions.size(); ++i) sorted[q].push_back(completions[i].word);
+        }
+        stopwatch.stop();
+        bst = stopwatch.get_elapsed_time_seconds() * 1e6 / count;
+        stopwatch.reset();
+        stopwatch.start();
+        for (size_t q = 0; q < count; ++q) agree += wordData.top_k_starting_with(prefixes[q], 10) == sorted[q];
+        stopwatch.stop();
+        radix = stopwatch.get_elapsed_time_seconds() * 1e6 / count;
+        std::cout << std::left << std::setw(8) << length << std::setw(26) << "top 10 completions" << std::right
+            << std::setw(12) << bst << std::setw(12) << radix << std::setw(12) << ""
+            << (agree == count ? "" : "   MISMATCH") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Accuracy and speed of WordSketch (HyperLogLog unique count, Space-Saving top k) next to the
+// exact answers: first on data/small-text.txt against WordData, then on synthetic Zipf
+// streams against a hash map, each stream split over four sketches that are merged at the end
+// as if they came from four threads or files.
+//
+// Usage: sketch_benchmark [stream length in millions of words] [heavy hitters] [precision]
+
+#include<iostream>
+#include<iomanip>
+#include<random>
+#include<string>
+#include<vector>
+#include<unordered_map>
+#include<algorithm>
+#include<cmath>
+#include<cstdint>
+
+#include "../word_sketch.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+// How many words of the sketch's top k truly belong there: ties with the exact k-th count count
+template <typename TrueCount>
+size_t recall(const std::vector<std::string>& approximate, TrueCount true_count, long long kth_count) {
+    size_t hits = 0;
+    for (const auto& word : approximate) hits += true_count(word) >= kth_count;
+    return hits;
+}
+
+void report_row(const std::string& name, long long exact_unique, const WordSketch& sketch, size_t hits, size_t k, double mean_error) {
+    double unique_error = 100.0 * (sketch.getUniqueWordCount() - exact_unique) / std::max(1LL, exact_unique);
+    std::cout << std::left << std::setw(26) << name << std::right << std::setw(12) << exact_unique << std::setw(12) << sketch.getUniqueWordCount()
+        << std::setw(9) << std::fixed << std::setprecision(2) << unique_error << "%" << std::setw(8) << hits << "/" << k
+        << std::setw(11) << mean_error * 100 << "%" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t millions = argc > 1 ? std::stoul(argv[1]) : 20;
+    const size_t heavy = argc > 2 ? std::stoul(argv[2]) : 1024;
+    const unsigned precision = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 14;
+    const size_t k = 100;
+
+    std::cout << "Sketch: " << heavy << " counters, 2^" << precision << " registers (expected unique count error "
+        << std::setprecision(2) << std::fixed << 104.0 / std::sqrt(static_cast<double>(size_t(1) << precision)) << "%)" << std::endl;
+    std::cout << std::left << std::setw(26) << "Stream" << std::right << std::setw(12) << "Unique" << std::setw(12) << "Estimate"
+        << std::setw(10) << "Error" << std::setw(10) << "Top " + std::to_string(k) << std::setw(12) << "Count err" << std::endl;
+
+    {
+        WordData exact("data/small-text.txt");
+        WordSketch sketch = sketchCorpus("data/small-text.txt", 4, heavy, precision);
+        auto exact_top = exact.top_k(static_cast<int>(k));
+        double error = 0;
+        for (const auto& word : exact_top) error += static_cast<double>(sketch.frequencyUpperBound(word) - exact.getFrequency(word)) / exact.getFrequency(word);
+        report_row("small-text.txt", exact.getUniqueWordCount(), sketch, recall(sketch.top_k(static_cast<int>(k)),
+            [&](const std::string& word) { return exact.getFrequency(word); }, exact_top.empty() ? 0 : exact.getFrequency(exact_top.back())),
+            exact_top.size(), error / std::max<size_t>(1, exact_top.size()));
+    }
+
+    for (size_t vocabulary : { size_t(100000), size_t(1000000), size_t(4000000) }) {
+        std::mt19937_64 rng(vocabulary);
+        // Zipf(1.05) ranks by inverse transform over the cumulative weights
+        std::vector<double> cumulative(vocabulary);
+        double sum = 0;
+        for (size_t i = 0; i < vocabulary; ++i) cumulative[i] = sum += std::pow(static_cast<double>(i + 1), -1.05);
+        std::uniform_real_distribution<double> uniform(0.0, sum);
+        auto word_of = [](size_t rank) {
+            std::string word = "w";
+            for (size_t r = rank * 2654435761u % 1000000007u; r > 0; r /= 26) word += static_cast<char>('a' + r % 26);
+            return word;
+        };
+
+        std::vector<std::uint32_t> ranks(millions * 1000000);
+        for (auto& rank : ranks)
+            rank = static_cast<std::uint32_t>(std::min<size_t>(std::lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin(), vocabulary - 1));
+
+        // Both loops make every word's string, which is part of either cost
+        Stopwatch stopwatch;
+        stopwatch.start();
+        std::unordered_map<std::string, long long> exact;
+        for (std::uint32_t rank : ranks) ++exact[word_of(rank)];
+        stopwatch.stop();
+        const double exact_seconds = stopwatch.get_elapsed_time_seconds();
+
+        stopwatch.reset();
+        stopwatch.start();
+        std::vector<WordSketch> parts(4, WordSketch(heavy, precision));
+        for (size_t i = 0; i < ranks.size(); ++i) parts[i % 4].insertNormalized(word_of(ranks[i]));
+        stopwatch.stop();
+        const double sketch_seconds = stopwatch.get_elapsed_time_seconds();
+        WordSketch sketch = parts[0];
+        for (size_t p = 1; p < parts.size(); ++p) sketch.merge(parts[p]);
+
+        std::vector<std::pair<long long, std::string>> ranked;
+        for (const auto& [word, count] : exact) ranked.emplace_back(count, word);
+        std::partial_sort(ranked.begin(), ranked.begin() + std::min(k, ranked.size()), ranked.end(), std::greater<>());
+        std::vector<std::string> exact_top;
+        double error = 0;
+        for (size_t i = 0; i < std::min(k, ranked.size()); ++i) {
+            exact_top.push_back(ranked[i].second);
+            error += static_cast<double>(sketch.frequencyUpperBound(ranked[i].second) - ranked[i].first) / ranked[i].first;
+        }
+        report_row(std::to_string(millions) + "M words, Zipf " + std::to_string(vocabulary / 1000) + "k", static_cast<long long>(exact.size()),
+            sketch, recall(sketch.top_k(static_cast<int>(k)), [&](const std::string& word) { auto it = exact.find(word); return it == exact.end() ? 0LL : it->second; },
+                exact_top.empty() ? 0 : ranked[exact_top.size() - 1].first), exact_top.size(), error / std::max<size_t>(1, exact_top.size()));
+        std::cout << std::setw(26) << "" << " exact map " << std::setprecision(1) << exact_seconds * 1e9 / ranks.size()
+            << " ns/word, sketches " << sketch_seconds * 1e9 / ranks.size() << " ns/word" << std::endl;
+    }
+    return 0;
+}
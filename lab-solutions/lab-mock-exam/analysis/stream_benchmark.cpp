@@ -0,0 +1,137 @@
+// Streaming ingestion with live queries: producer threads feed 64 KB chunks of text while one
+// consumer thread keeps asking for word frequencies. ConcurrentWordData (sharded, batched per
+// chunk) against a WordData behind one mutex, locked once per chunk. Reports the text
+// throughput, the consumer's query rate and whether both end with the same counts.
+//
+// Usage: stream_benchmark [text size in MB]
+
+#include<iostream>
+#include<iomanip>
+#include<fstream>
+#include<sstream>
+#include<string>
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<atomic>
+#include<random>
+#include<algorithm>
+
+#include "../concurrent_word_table.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+// The baseline: the whole tree behind one lock
+class LockedWordData {
+    WordData wordData;
+    mutable std::mutex mutex;
+
+public:
+    size_t insertText(std::string_view text) {
+        thread_local Tokenizer tokenizer;
+        std::lock_guard<std::mutex> lock(mutex);
+        return tokenizer.forEachWord(text, [&](std::string_view word) { wordData.insert(Word(std::string(word), 1)); });
+    }
+
+    int getFrequency(const std::string& word) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return wordData.getFrequency(word);
+    }
+
+    std::vector<Word> snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Word> words;
+        wordData.inOrder([&](const Word& word) { words.push_back(word); });
+        return words;
+    }
+};
+
+std::vector<std::string> make_chunks(size_t size_mb) {
+    std::ifstream in("data/small-text.txt");
+    if (!in.is_open()) throw std::runtime_error("Could not open file: data/small-text.txt");
+    std::stringstream text;
+    text << in.rdbuf();
+    std::vector<std::string> tokens;
+    std::string token;
+    while (text >> token) tokens.push_back(token);
+
+    // Every fifth token gets a suffix from a growing counter, so the vocabulary keeps growing
+    std::vector<std::string> chunks(1);
+    size_t total = 0, counter = 0;
+    while (total < (size_mb << 20)) {
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            std::string word = tokens[i];
+            if (i % 5 == 0) for (size_t r = ++counter % 50000; r > 0; r /= 26) word += static_cast<char>('a' + r % 26);
+            chunks.back() += word;
+            chunks.back() += ' ';
+            total += word.size() + 1;
+            if (chunks.back().size() >= (64 << 10)) chunks.emplace_back();
+        }
+    }
+    return chunks;
+}
+
+struct Result {
+    double seconds;
+    double queries_per_second;
+};
+
+// Runs producers threads over all chunks while one consumer queries
+template <typename Table>
+Result run(Table& table, const std::vector<std::string>& chunks, unsigned producers, const std::vector<std::string>& probes) {
+    std::atomic<size_t> next{ 0 };
+    std::atomic<bool> done{ false };
+    size_t queries = 0;
+    Stopwatch stopwatch;
+    stopwatch.start();
+    std::thread consumer([&]() {
+        std::mt19937 rng(7);
+        long long sum = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            sum += table.getFrequency(probes[rng() % probes.size()]);
+            ++queries;
+        }
+        if (sum < 0) std::cout << sum; // Keeps the queries from being optimized away
+        });
+    std::vector<std::thread> pool;
+    for (unsigned p = 0; p < producers; ++p) {
+        pool.emplace_back([&]() {
+            for (size_t i; (i = next.fetch_add(1)) < chunks.size();) table.insertText(chunks[i]);
+            });
+    }
+    for (auto& thread : pool) thread.join();
+    stopwatch.stop();
+    done = true;
+    consumer.join();
+    double seconds = stopwatch.get_elapsed_time_seconds();
+    return { seconds, queries / seconds };
+}
+
+int main(int argc, char* argv[]) {
+    const size_t size_mb = argc > 1 ? std::stoul(argv[1]) : 64;
+    const auto chunks = make_chunks(size_mb);
+    const double megabytes = static_cast<double>(size_mb);
+    const std::vector<std::string> probes = { "the", "data", "algorithm", "and", "of", "structures", "missing" };
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "Text: " << size_mb << " MB in " << chunks.size() << " chunks, cores: " << cores << ", one consumer" << std::endl;
+    std::cout << std::left << std::setw(11) << "Producers" << std::right
+        << std::setw(14) << "Sharded MB/s" << std::setw(14) << "queries/s"
+        << std::setw(14) << "Mutex MB/s" << std::setw(14) << "queries/s" << std::endl;
+    bool same = true;
+    for (unsigned producers = 1; producers <= 2 * cores; producers *= 2) {
+        ConcurrentWordData sharded;
+        LockedWordData locked;
+        Result a = run(sharded, chunks, producers, probes);
+        Result b = run(locked, chunks, producers, probes);
+        auto a_words = sharded.snapshot(), b_words = locked.snapshot();
+        // Word::operator== compares only the words
+        same = same && std::equal(a_words.begin(), a_words.end(), b_words.begin(), b_words.end(),
+            [](const Word& x, const Word& y) { return x.word == y.word && x.frequency == y.frequency; });
+        std::cout << std::left << std::setw(11) << producers << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << megabytes / a.seconds << std::setw(14) << std::setprecision(0) << a.queries_per_second
+            << std::setw(14) << std::setprecision(1) << megabytes / b.seconds << std::setw(14) << std::setprecision(0) << b.queries_per_second
+            << std::endl;
+    }
+    std::cout << (same ? "Final counts agree" : "MISMATCH") << std::endl;
+    return 0;
+}
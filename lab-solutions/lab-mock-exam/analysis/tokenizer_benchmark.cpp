@@ -0,0 +1,77 @@
+// Tokenizing and normalizing a large text in memory: the previous path (getline, istringstream
+// >> and WordData::normalize per token) against the vectorized Tokenizer. The text repeats
+// data/small-text.txt; which Tokenizer variant runs depends on the compiler flags, e.g.
+//
+//     g++ -O2 -std=c++17 tokenizer_benchmark.cpp            (SSE2 on x86-64)
+//     g++ -O2 -std=c++17 -mavx2 tokenizer_benchmark.cpp     (AVX2)
+//
+// Usage: tokenizer_benchmark [text size in MB]
+
+#include<iostream>
+#include<iomanip>
+#include<fstream>
+#include<sstream>
+#include<string>
+#include<vector>
+
+#include "../word_data.hpp"
+#include "../simd_tokenizer.hpp"
+#include "../../Lab10/Stopwatch.hpp"
+
+int main(int argc, char* argv[]) {
+    const size_t size_mb = argc > 1 ? std::stoul(argv[1]) : 256;
+
+    std::ifstream in("data/small-text.txt");
+    if (!in.is_open()) throw std::runtime_error("Could not open file: data/small-text.txt");
+    std::stringstream sample;
+    sample << in.rdbuf();
+    std::string text;
+    while (text.size() < (size_mb << 20)) text += sample.str();
+
+#if defined(SIMD_TOKENIZER_AVX2)
+    const char* variant = "AVX2";
+#elif defined(SIMD_TOKENIZER_SSE2)
+    const char* variant = "SSE2";
+#else
+    const char* variant = "scalar";
+#endif
+    std::cout << "Text: " << text.size() / (1 << 20) << " MB, Tokenizer variant: " << variant << std::endl;
+
+    WordData wordData; // Only for normalize
+    Stopwatch stopwatch;
+    stopwatch.start();
+    size_t words = 0, letters = 0;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        while (iss >> word) {
+            word = wordData.normalize(word);
+            if (!word.empty()) {
+                ++words;
+                letters += word.size();
+            }
+        }
+    }
+    stopwatch.stop();
+    double stream_seconds = stopwatch.get_elapsed_time_seconds();
+
+    Tokenizer tokenizer;
+    size_t simd_words = 0, simd_letters = 0;
+    stopwatch.reset();
+    stopwatch.start();
+    simd_words = tokenizer.forEachWord(text, [&](std::string_view word) { simd_letters += word.size(); });
+    stopwatch.stop();
+    double simd_seconds = stopwatch.get_elapsed_time_seconds();
+
+    const double gigabytes = text.size() / 1e9;
+    std::cout << std::left << std::setw(34) << "Method" << std::right << std::setw(10) << "Seconds" << std::setw(10) << "GB/s" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::left << std::setw(34) << "istringstream + normalize" << std::right
+        << std::setw(10) << stream_seconds << std::setw(10) << gigabytes / stream_seconds << std::endl;
+    std::cout << std::left << std::setw(34) << "Tokenizer" << std::right
+        << std::setw(10) << simd_seconds << std::setw(10) << gigabytes / simd_seconds << std::endl;
+    std::cout << words << " words, " << (words == simd_words && letters == simd_letters ? "same words" : "MISMATCH") << std::endl;
+    return 0;
+}
@@ -0,0 +1,168 @@
+#ifndef CONCURRENT_WORD_TABLE_HPP
+#define CONCURRENT_WORD_TABLE_HPP
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+
+#include "word_data.hpp"
+#include "simd_tokenizer.hpp"
+
+
+// Word frequencies for many writer and reader threads at once, e.g. producers streaming text
+// in while a consumer queries counts live:
+//
+//     ConcurrentWordData words;
+//     // Any thread:
+//     words.insertText(chunk);
+//     int n = words.getFrequency("data");
+//     // A consistent, sorted copy:
+//     std::vector<Word> snapshot = words.snapshot();
+//
+// The words are spread over a fixed number of shards by hash, each a hash map behind its own
+// reader-writer lock (lock striping), so writers and readers only contend when they touch the
+// same shard at the same moment. insertText tokenizes its text like WordData's constructor,
+// counts the words in a local table without any lock, and then adds them one shard at a time,
+// so the locking cost is paid per shard and batch rather than per token.
+//
+// Batches also hold a gate, a reader-writer lock that they share. snapshot() and exportToFile()
+// take it exclusively, which waits for the batches in progress and holds off new ones, and then
+// lock all shards for as long as the copy takes: the result is one point in time, with every
+// batch either fully in or fully out.
+class ConcurrentWordData {
+    static constexpr size_t shard_count = 64;
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, int> counts;
+        long long total = 0; // Sum of counts
+    };
+
+    Shard shards[shard_count];
+    mutable std::shared_mutex gate;  // Shared by every batch in progress, exclusive for a snapshot
+    mutable std::mutex turnstile;    // Held by a waiting snapshot, so new batches queue behind it
+
+    static size_t shardOf(std::string_view word) { return std::hash<std::string_view>{}(word) % shard_count; }
+
+    // Holds every shard's lock, shared or exclusive, in shard order
+    template <typename Lock>
+    std::vector<Lock> lockAll() const {
+        std::vector<Lock> locks;
+        locks.reserve(shard_count);
+        for (const Shard& shard : shards) locks.emplace_back(shard.mutex);
+        return locks;
+    }
+
+public:
+    ConcurrentWordData() = default;
+    ConcurrentWordData(const ConcurrentWordData&) = delete;
+    ConcurrentWordData& operator=(const ConcurrentWordData&) = delete;
+
+    // Adds word.frequency to word.word as it is, like WordData::insert
+    void insert(const Word& word) {
+        Shard& shard = shards[shardOf(word.word)];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.counts[word.word] += word.frequency;
+        shard.total += word.frequency;
+    }
+
+    // Tokenizes and normalizes text like WordData(path) and counts its words as one batch;
+    // returns the number of words
+    size_t insertText(std::string_view text) {
+        thread_local Tokenizer tokenizer;
+        thread_local std::unordered_map<std::string_view, int> local;
+        thread_local std::vector<std::vector<std::pair<std::string_view, int>>> byShard(shard_count);
+
+        local.clear();
+        size_t words = tokenizer.forEachWord(text, [&](std::string_view word) { ++local[word]; });
+        for (auto& list : byShard) list.clear();
+        for (const auto& entry : local) byShard[shardOf(entry.first)].push_back(entry);
+
+        // Readers see the batch shard by shard; a snapshot waits for the gate, so it sees all of
+        // the batch or none
+        { std::lock_guard<std::mutex> wait(turnstile); }
+        std::shared_lock<std::shared_mutex> batch(gate);
+        for (size_t s = 0; s < shard_count; ++s) {
+            if (byShard[s].empty()) continue;
+            std::unique_lock<std::shared_mutex> lock(shards[s].mutex);
+            for (const auto& [word, count] : byShard[s]) {
+                shards[s].counts[std::string(word)] += count;
+                shards[s].total += count;
+            }
+        }
+        return words;
+    }
+
+    int getFrequency(const std::string& word) const {
+        std::string key = WordData::normalize(word);
+        const Shard& shard = shards[shardOf(key)];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.counts.find(key);
+        return it == shard.counts.end() ? 0 : it->second;
+    }
+
+    bool containsWord(const std::string& word) const {
+        std::string key = WordData::normalize(word);
+        const Shard& shard = shards[shardOf(key)];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.counts.count(key) != 0;
+    }
+
+    // Sums shard by shard, so concurrent inserts may be partly counted; snapshot() is exact
+    long long getTotalWordCount() const {
+        long long total = 0;
+        for (const Shard& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            total += shard.total;
+        }
+        return total;
+    }
+
+    size_t getUniqueWordCount() const {
+        size_t unique = 0;
+        for (const Shard& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            unique += shard.counts.size();
+        }
+        return unique;
+    }
+
+    // Every word with its frequency at one point in time, sorted alphabetically
+    std::vector<Word> snapshot() const {
+        std::vector<Word> words;
+        {
+            std::unique_lock<std::mutex> first(turnstile);
+            std::unique_lock<std::shared_mutex> noBatches(gate);
+            auto locks = lockAll<std::shared_lock<std::shared_mutex>>(); // For insert, which skips the gate
+            size_t unique = 0;
+            for (const Shard& shard : shards) unique += shard.counts.size();
+            words.reserve(unique);
+            for (const Shard& shard : shards)
+                for (const auto& [word, count] : shard.counts) words.emplace_back(word, count);
+        }
+        std::sort(words.begin(), words.end()); // After unlocking; the copy is already consistent
+        return words;
+    }
+
+    // Same format and order as WordData::exportToFile, from one snapshot
+    void exportToFile(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file.is_open()) throw std::runtime_error("Could not open file: " + path);
+        for (const Word& word : snapshot()) file << std::left << std::setw(20) << word.word << word.frequency << "\n";
+        file.close();
+    }
+
+    // The snapshot as a WordData, for the single-threaded queries (prefixes, top k, ...)
+    void copyTo(WordData& wordData) const { wordData.insertSorted(snapshot()); }
+};
+
+#endif // CONCURRENT_WORD_TABLE_HPP
@@ -0,0 +1,291 @@
+#ifndef CORPUS_INGEST_HPP
+#define CORPUS_INGEST_HPP
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "word_data.hpp"
+#include "mapped_file.hpp"
+
+
+// Parallel corpus ingestion for WordData:
+//
+//     WordData wordData;
+//     IngestStats stats = ingestCorpus(wordData, "data/corpus.txt");
+//     std::cout << stats.gigabytesPerSecond() << " GB/s" << std::endl;
+//
+// The file is mapped into memory (read into one buffer where mmap is unavailable) and split
+// into one chunk per thread, moving every split point forward to the next whitespace so that
+// no word is cut in two. Each thread tokenizes its chunk in place with the same rules as
+// WordData's constructor (whitespace-separated tokens, letters only, lower case) and counts
+// the words in its own open-addressing hash table. A word is copied once, into the thread's
+// arena, the first time that thread sees it. The tables are then merged in parallel, each
+// thread taking the words whose hash falls into its partition, and the unique words are
+// inserted into the tree in sorted, median-first order.
+struct IngestStats {
+    size_t bytes = 0;
+    size_t tokens = 0;
+    size_t uniqueWords = 0;
+    unsigned threads = 0;
+    double countSeconds = 0.0;    // Mapping, tokenizing and counting
+    double mergeSeconds = 0.0;    // Merging the per-thread tables and sorting the words
+    double insertSeconds = 0.0;   // Building the tree
+
+    double totalSeconds() const { return countSeconds + mergeSeconds + insertSeconds; }
+    double gigabytesPerSecond() const { return totalSeconds() > 0 ? bytes / 1e9 / totalSeconds() : 0.0; }
+};
+
+namespace corpus_detail {
+
+    // The characters std::istringstream >> treats as separators in the "C" locale
+    inline bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+    // ASCII letters only, like std::isalpha in the "C" locale
+    inline bool isLetter(char c) { return static_cast<unsigned char>((c | 0x20) - 'a') < 26; }
+
+    // Append-only storage for the words, in large blocks so that views stay valid
+    class Arena {
+        std::vector<std::unique_ptr<char[]>> blocks;
+        size_t used = 0, capacity = 0;
+
+    public:
+        std::string_view store(const char* data, size_t size) {
+            if (used + size > capacity) {
+                capacity = std::max<size_t>(size, 1 << 20);
+                blocks.emplace_back(new char[capacity]);
+                used = 0;
+            }
+            char* destination = blocks.back().get() + used;
+            std::memcpy(destination, data, size);
+            used += size;
+            return std::string_view(destination, size);
+        }
+    };
+
+    // Open addressing with linear probing; the hash is stored to skip most string compares
+    class CountTable {
+    public:
+        struct Entry {
+            std::uint64_t hash = 0;
+            std::string_view word;   // Empty for a free slot (empty words are never counted)
+            std::uint64_t count = 0;
+        };
+
+    private:
+        std::vector<Entry> entries;
+        size_t used = 0;
+
+        void grow() {
+            std::vector<Entry> old(entries.size() * 2);
+            old.swap(entries);
+            const size_t mask = entries.size() - 1;
+            for (const Entry& entry : old) {
+                if (entry.word.empty()) continue;
+                size_t slot = entry.hash & mask;
+                while (!entries[slot].word.empty()) slot = (slot + 1) & mask;
+                entries[slot] = entry;
+            }
+        }
+
+    public:
+        explicit CountTable(size_t capacity = 1 << 14) {
+            size_t size = 16;
+            while (size < capacity) size *= 2;
+            entries.resize(size);
+        }
+
+        // Adds count to word; a new word is kept as the view store(word) returns
+        template <typename Store>
+        void add(std::uint64_t hash, std::string_view word, std::uint64_t count, Store store) {
+            const size_t mask = entries.size() - 1;
+            size_t slot = hash & mask;
+            while (!entries[slot].word.empty()) {
+                Entry& entry = entries[slot];
+                if (entry.hash == hash && entry.word == word) {
+                    entry.count += count;
+                    return;
+                }
+                slot = (slot + 1) & mask;
+            }
+            entries[slot] = Entry{ hash, store(word), count };
+            if (++used * 2 > entries.size()) grow(); // Keep the load factor at most 1/2
+        }
+
+        // The entry of word, nullptr if it was never added
+        const Entry* find(std::uint64_t hash, std::string_view word) const {
+            const size_t mask = entries.size() - 1;
+            for (size_t slot = hash & mask; !entries[slot].word.empty(); slot = (slot + 1) & mask)
+                if (entries[slot].hash == hash && entries[slot].word == word) return &entries[slot];
+            return nullptr;
+        }
+
+        const std::vector<Entry>& slots() const { return entries; }
+        size_t size() const { return used; }
+    };
+
+    // FNV-1a, the hash countChunk computes while it normalizes
+    inline std::uint64_t hashWord(std::string_view word) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (char c : word) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        return hash;
+    }
+
+    // splitmix64's finalizer, which spreads the bits of a key (an FNV-1a hash, packed ids) over
+    // all 64 for tables and sketches that take the low or high bits
+    inline std::uint64_t mix(std::uint64_t key) {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ull;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebull;
+        return key ^ (key >> 31);
+    }
+
+    // Split points of n bytes into one chunk per thread, at most one per 64 KB, each moved
+    // forward to whitespace so that every token lies in one chunk; chunk t is [bounds[t],
+    // bounds[t + 1])
+    inline std::vector<size_t> splitChunks(const char* data, size_t n, unsigned threads) {
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, n / (1 << 16) + 1)));
+        std::vector<size_t> bounds(threads + 1, n);
+        bounds[0] = 0;
+        for (unsigned t = 1; t < threads; ++t) {
+            size_t bound = std::max(bounds[t - 1], n / threads * t);
+            while (bound < n && !isSpace(data[bound])) ++bound;
+            bounds[t] = bound;
+        }
+        return bounds;
+    }
+
+    // Calls piece(std::string_view) for [begin, end) of data 1 MB at a time, each piece cut
+    // after whitespace, so a tokenizer that works piece by piece keeps its arena small
+    template <typename Piece>
+    void forEachPiece(const char* data, size_t begin, size_t end, Piece piece) {
+        for (size_t at = begin; at < end;) {
+            size_t cut = std::min(end, at + (1 << 20));
+            while (cut < end && !isSpace(data[cut])) ++cut;
+            piece(std::string_view(data + at, cut - at));
+            at = cut;
+        }
+    }
+
+    // Tokenizes [begin, end) the way WordData's constructor does and counts the words
+    inline size_t countChunk(const char* begin, const char* end, CountTable& table, Arena& arena) {
+        std::string buffer; // Reused for every token; only grows for unusually long tokens
+        size_t tokens = 0;
+        const char* p = begin;
+        while (p < end) {
+            while (p < end && isSpace(*p)) ++p;
+            if (p == end) break;
+            buffer.clear();
+            std::uint64_t hash = 14695981039346656037ull; // FNV-1a over the normalized word
+            for (; p < end && !isSpace(*p); ++p) {
+                if (!isLetter(*p)) continue;
+                char c = static_cast<char>(*p | 0x20);
+                buffer.push_back(c);
+                hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+            }
+            if (buffer.empty()) continue;
+            table.add(hash, buffer, 1, [&](std::string_view word) { return arena.store(word.data(), word.size()); });
+            ++tokens;
+        }
+        return tokens;
+    }
+
+    inline double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+/**
+ * @brief Counts the words of the corpus at path in parallel.
+ *
+ * @return The unique words with their frequencies, sorted alphabetically.
+ */
+inline std::vector<Word> countCorpus(const std::string& path,
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency()), IngestStats* stats = nullptr) {
+    using namespace corpus_detail;
+    IngestStats local;
+    IngestStats& s = stats ? *stats : local;
+    s = IngestStats();
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file(path, true);
+    const char* data = file.data();
+    const size_t n = file.size();
+    const std::vector<size_t> bounds = splitChunks(data, n, threads);
+    threads = static_cast<unsigned>(bounds.size() - 1);
+    s.bytes = n;
+    s.threads = threads;
+
+    std::vector<CountTable> tables(threads);
+    std::vector<Arena> arenas(threads);
+    std::vector<size_t> tokens(threads, 0);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+        pool.emplace_back([&, t]() { tokens[t] = countChunk(data + bounds[t], data + bounds[t + 1], tables[t], arenas[t]); });
+    for (auto& thread : pool) thread.join();
+    for (size_t count : tokens) s.tokens += count;
+    s.countSeconds = secondsSince(start);
+
+    // Merge: thread p owns the words whose upper hash bits are p modulo threads (the tables index
+    // by the lower bits), so no two threads share a word
+    start = std::chrono::steady_clock::now();
+    std::vector<std::vector<Word>> partitions(threads);
+    pool.clear();
+    for (unsigned p = 0; p < threads; ++p) {
+        pool.emplace_back([&, p]() {
+            std::vector<Word>& partition = partitions[p];
+            if (threads == 1) { // A single table already holds every word once
+                partition.reserve(tables[0].size());
+                for (const auto& entry : tables[0].slots())
+                    if (!entry.word.empty()) partition.emplace_back(std::string(entry.word), static_cast<int>(entry.count));
+            }
+            else {
+                size_t expected = 0;
+                for (const CountTable& table : tables) expected += table.size();
+                CountTable merged(expected / threads * 2);
+                auto keep = [](std::string_view word) { return word; }; // Already in a thread's arena
+                for (const CountTable& table : tables)
+                    for (const auto& entry : table.slots())
+                        if (!entry.word.empty() && (entry.hash >> 32) % threads == p) merged.add(entry.hash, entry.word, entry.count, keep);
+                partition.reserve(merged.size());
+                for (const auto& entry : merged.slots())
+                    if (!entry.word.empty()) partition.emplace_back(std::string(entry.word), static_cast<int>(entry.count));
+            }
+            std::sort(partition.begin(), partition.end());
+            });
+    }
+    for (auto& thread : pool) thread.join();
+
+    std::vector<Word> words;
+    for (auto& partition : partitions) {
+        size_t middle = words.size();
+        words.insert(words.end(), std::make_move_iterator(partition.begin()), std::make_move_iterator(partition.end()));
+        std::inplace_merge(words.begin(), words.begin() + middle, words.end());
+    }
+    s.uniqueWords = words.size();
+    s.mergeSeconds = secondsSince(start);
+    return words;
+}
+
+// Counts the corpus at path in parallel and adds its words to wordData
+inline IngestStats ingestCorpus(WordData& wordData, const std::string& path,
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+    IngestStats stats;
+    std::vector<Word> words = countCorpus(path, threads, &stats);
+    auto start = std::chrono::steady_clock::now();
+    wordData.insertSorted(words);
+    stats.insertSeconds = corpus_detail::secondsSince(start);
+    return stats;
+}
+
+#endif // CORPUS_INGEST_HPP
@@ -0,0 +1,102 @@
+#ifndef FREQUENCY_BUCKETS_HPP
+#define FREQUENCY_BUCKETS_HPP
+
+#include <string_view>
+#include <set>
+#include <map>
+#include <type_traits>
+
+
+// Words grouped by frequency, kept up to date as counts change, so that frequency-ordered
+// queries never sort.
+//
+// Every distinct frequency has a bucket: an ordered set of the words with that frequency, so
+// ties always come out alphabetically, whatever order the words reached their count in (and
+// match a WordIndexFile's). The buckets live in a map ordered by frequency. Adding to a word's
+// count moves its set node to the bucket for the new count (O(log b) for a bucket of b words,
+// no allocation); for the common +1 that bucket is the next one or a new one right after it,
+// found in O(1) amortized with a hint. Empty buckets are removed, so walking k words from
+// either end of the map only visits the buckets they are in.
+//
+// The position of a word is its Entry, which the owner keeps next to the word (WordData keeps
+// one in every tree node), so a count change needs no lookup of the word itself. The word an
+// Entry views must outlive it.
+class FrequencyBuckets {
+public:
+    struct Entry {
+        std::string_view word;
+        int frequency = 0;
+    };
+
+private:
+    using Bucket = std::set<std::string_view>;
+
+    std::map<int, Bucket> buckets;          // Non-empty buckets by frequency
+    std::map<size_t, Bucket> lengths;       // Words by length
+    size_t wordCount = 0;
+
+    // Calls visitor(word, frequency) for the words of a bucket in order; false once the visitor
+    // stopped
+    template <typename Visitor>
+    static bool visit(const Bucket& bucket, int frequency, Visitor& visitor) {
+        for (std::string_view word : bucket) {
+            if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::string_view, int>>) visitor(word, frequency);
+            else if (!visitor(word, frequency)) return false;
+        }
+        return true;
+    }
+
+public:
+    // Adds a new word with the given frequency; entry is its position from now on
+    void insert(Entry& entry, std::string_view word, int frequency) {
+        entry.word = word;
+        entry.frequency = frequency;
+        lengths[word.size()].insert(word);
+        buckets[frequency].insert(word);
+        ++wordCount;
+    }
+
+    // Adds count to the frequency of the word at entry
+    void add(Entry& entry, int count) {
+        if (count == 0) return;
+        auto from = buckets.find(entry.frequency);
+        entry.frequency += count;
+        auto to = count == 1 ? std::next(from) : buckets.lower_bound(entry.frequency);
+        if (to == buckets.end() || to->first != entry.frequency) to = buckets.emplace_hint(to, entry.frequency, Bucket());
+        to->second.insert(from->second.extract(entry.word));
+        if (from->second.empty()) buckets.erase(from);
+    }
+
+    // Streams the words from the most to the least frequent to visitor(std::string_view word,
+    // int frequency); ties come in alphabetical order. A visitor that returns false stops the
+    // walk, so the first k words cost O(k).
+    template <typename Visitor>
+    void forEachMostFrequent(Visitor visitor) const {
+        for (auto it = buckets.rbegin(); it != buckets.rend(); ++it)
+            if (!visit(it->second, it->first, visitor)) return;
+    }
+
+    // As forEachMostFrequent, from the least frequent word up
+    template <typename Visitor>
+    void forEachLeastFrequent(Visitor visitor) const {
+        for (auto it = buckets.begin(); it != buckets.end(); ++it)
+            if (!visit(it->second, it->first, visitor)) return;
+    }
+
+    // All words with the highest frequency
+    template <typename Visitor>
+    void forEachWithMaxFrequency(Visitor visitor) const {
+        if (!buckets.empty()) visit(buckets.rbegin()->second, buckets.rbegin()->first, visitor);
+    }
+
+    // All words of the greatest length, to visitor(std::string_view word, size_t length)
+    template <typename Visitor>
+    void forEachLongest(Visitor visitor) const {
+        if (lengths.empty()) return;
+        for (std::string_view word : lengths.rbegin()->second) visitor(word, lengths.rbegin()->first);
+    }
+
+    size_t size() const { return wordCount; }
+};
+
+#endif // FREQUENCY_BUCKETS_HPP
@@ -0,0 +1,75 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_MMAP 1
+#endif
+
+
+// Read-only view of a whole file: mapped into memory where mmap is available, read into one
+// buffer elsewhere. Sequential readers (a corpus scan) ask for read-ahead; random readers (an
+// index) leave the kernel's default and only touch the pages they look up.
+class MappedFile {
+    const char* bytes = nullptr;
+    size_t length = 0;
+    std::vector<char> fallback;
+#if defined(MAPPED_FILE_MMAP)
+    void* mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path, bool sequential = false) {
+#if defined(MAPPED_FILE_MMAP)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Could not open file: " + path);
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not open file: " + path);
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Could not map file: " + path);
+            }
+            if (sequential) ::madvise(mapping, length, MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(mapping);
+        }
+        ::close(fd);
+#else
+        (void)sequential;
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) throw std::runtime_error("Could not open file: " + path);
+        length = static_cast<size_t>(file.tellg());
+        fallback.resize(length);
+        file.seekg(0);
+        file.read(fallback.data(), static_cast<std::streamsize>(length));
+        bytes = fallback.data();
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(MAPPED_FILE_MMAP)
+        if (mapping) ::munmap(mapping, length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,447 @@
+#ifndef NGRAM_STATS_HPP
+#define NGRAM_STATS_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "word_data.hpp"
+#include "corpus_ingest.hpp"
+#include "mapped_file.hpp"
+#include "simd_tokenizer.hpp"
+
+
+struct NgramOptions {
+    unsigned window = 5;              // Co-occurrence: pairs at most this many words apart; 0 for none
+    bool trigrams = true;             // Needs fewer than 2^21 distinct words (21-bit ids in the key)
+    bool sketch = false;              // Count-min sketches instead of exact tables: bounded memory
+    size_t sketchWidth = 1 << 18;     // Sketch mode: counters per row, rounded up to a power of 2
+    unsigned sketchDepth = 4;         // Sketch mode: rows
+    size_t candidates = 1 << 16;      // Sketch mode: heavy pairs each thread keeps per kind
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+namespace ngram_detail {
+
+    enum Kind { Bigram, Trigram, Cooccurrence, KindCount };
+
+    // Ids start at 1, so no packed key is 0 and 0 can mark a free slot
+    inline std::uint64_t bigramKey(std::uint32_t a, std::uint32_t b) { return static_cast<std::uint64_t>(a) << 32 | b; }
+    inline std::uint64_t trigramKey(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+        return static_cast<std::uint64_t>(a) << 42 | static_cast<std::uint64_t>(b) << 21 | c;
+    }
+
+    // The key without its last word, which is what top-successor queries look up
+    inline unsigned groupShift(Kind kind) { return kind == Trigram ? 21 : 32; }
+
+    using corpus_detail::mix;
+
+    // Open addressing with linear probing from packed keys to counts
+    class GramTable {
+    public:
+        struct Entry {
+            std::uint64_t key = 0; // 0 for a free slot
+            std::uint64_t count = 0;
+        };
+
+    private:
+        std::vector<Entry> entries;
+        size_t used = 0;
+
+        void place(const Entry& entry) {
+            const size_t mask = entries.size() - 1;
+            size_t slot = mix(entry.key) & mask;
+            while (entries[slot].key) slot = (slot + 1) & mask;
+            entries[slot] = entry;
+        }
+
+    public:
+        explicit GramTable(size_t capacity = 1 << 12) {
+            size_t size = 16;
+            while (size < 2 * capacity) size *= 2;
+            entries.resize(size);
+        }
+
+        void add(std::uint64_t key, std::uint64_t count) {
+            const size_t mask = entries.size() - 1;
+            size_t slot = mix(key) & mask;
+            for (; entries[slot].key; slot = (slot + 1) & mask) {
+                if (entries[slot].key == key) {
+                    entries[slot].count += count;
+                    return;
+                }
+            }
+            entries[slot] = Entry{ key, count };
+            if (++used * 2 > entries.size()) { // Keep the load factor at most 1/2
+                std::vector<Entry> old(entries.size() * 2);
+                old.swap(entries);
+                for (const Entry& entry : old) if (entry.key) place(entry);
+            }
+        }
+
+        std::uint64_t count(std::uint64_t key) const {
+            const size_t mask = entries.size() - 1;
+            for (size_t slot = mix(key) & mask; entries[slot].key; slot = (slot + 1) & mask)
+                if (entries[slot].key == key) return entries[slot].count;
+            return 0;
+        }
+
+        // Misra-Gries: subtracts the count below which all but the capacity / 2 largest fall and
+        // drops the keys that reach 0. A key more frequent than 2 / capacity of everything added
+        // is never dropped.
+        void prune(size_t capacity) {
+            std::vector<std::uint64_t> counts;
+            counts.reserve(used);
+            for (const Entry& entry : entries) if (entry.key) counts.push_back(entry.count);
+            auto cut = counts.begin() + static_cast<std::ptrdiff_t>(counts.size() - std::min(counts.size(), capacity / 2 + 1));
+            std::nth_element(counts.begin(), cut, counts.end());
+            const std::uint64_t threshold = *cut;
+            std::vector<Entry> old(entries.size());
+            old.swap(entries);
+            used = 0;
+            for (const Entry& entry : old) {
+                if (entry.key && entry.count > threshold) {
+                    place(Entry{ entry.key, entry.count - threshold });
+                    ++used;
+                }
+            }
+        }
+
+        const std::vector<Entry>& slots() const { return entries; }
+        size_t size() const { return used; }
+    };
+
+    // depth rows of width counters, each key counted once per row; the smallest of its counters
+    // is never below its true count. Sketches of the same shape merge by adding counters.
+    class CountMinSketch {
+        std::vector<std::uint64_t> counters;
+        size_t width = 0;
+        unsigned depth = 0;
+
+        size_t cell(unsigned row, std::uint64_t key) const {
+            return row * width + (mix(key + 0x9e3779b97f4a7c15ull * (row + 1)) & (width - 1));
+        }
+
+    public:
+        CountMinSketch() = default;
+        CountMinSketch(size_t width, unsigned depth) : width(1), depth(std::max(1u, depth)) {
+            while (this->width < width) this->width *= 2;
+            counters.assign(this->width * this->depth, 0);
+        }
+
+        void add(std::uint64_t key, std::uint64_t count) {
+            for (unsigned row = 0; row < depth; ++row) counters[cell(row, key)] += count;
+        }
+
+        std::uint64_t estimate(std::uint64_t key) const {
+            std::uint64_t least = UINT64_MAX;
+            for (unsigned row = 0; row < depth; ++row) least = std::min(least, counters[cell(row, key)]);
+            return depth ? least : 0;
+        }
+
+        // Adds the counters [from, to) of other, so that threads can merge disjoint ranges
+        void merge(const CountMinSketch& other, size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i) counters[i] += other.counters[i];
+        }
+
+        size_t cells() const { return counters.size(); }
+    };
+
+    // One thread's counts of every kind
+    struct Counter {
+        GramTable tables[KindCount];        // Exact counts, or the heavy-pair candidates in sketch mode
+        CountMinSketch sketches[KindCount]; // Sketch mode only
+        const NgramOptions* options = nullptr;
+
+        explicit Counter(const NgramOptions& options) : options(&options) {
+            if (options.sketch)
+                for (auto& sketch : sketches) sketch = CountMinSketch(options.sketchWidth, options.sketchDepth);
+        }
+
+        void add(Kind kind, std::uint64_t key) {
+            if (!options->sketch) {
+                tables[kind].add(key, 1);
+                return;
+            }
+            sketches[kind].add(key, 1);
+            tables[kind].add(key, 1);
+            if (tables[kind].size() >= options->candidates) tables[kind].prune(options->candidates);
+        }
+    };
+
+    // Counts the n-grams ending at each word fed to it; keeps the first and last words it saw for
+    // the pairs that cross into the neighbouring chunks
+    class Window {
+        std::vector<std::uint32_t> recent; // Ring of the last span ids
+        size_t seen = 0;
+        const NgramOptions& options;
+
+    public:
+        std::vector<std::uint32_t> head; // The first span ids
+
+        explicit Window(const NgramOptions& options) : recent(std::max(2u, options.window)), options(options) {}
+
+        size_t span() const { return recent.size(); }
+
+        // The id `back` words before the current one (1 = the previous word)
+        std::uint32_t before(size_t back) const { return recent[(seen - back) % recent.size()]; }
+        size_t size() const { return std::min(seen, recent.size()); }
+
+        void push(std::uint32_t id, Counter& counter) {
+            if (seen >= 1) counter.add(Bigram, bigramKey(before(1), id));
+            if (seen >= 2 && options.trigrams) counter.add(Trigram, trigramKey(before(2), before(1), id));
+            for (size_t back = 1; back <= std::min<size_t>(options.window, seen); ++back) {
+                std::uint32_t other = before(back);
+                if (other != id) counter.add(Cooccurrence, bigramKey(std::min(other, id), std::max(other, id)));
+            }
+            if (seen < recent.size()) head.push_back(id);
+            recent[seen++ % recent.size()] = id;
+        }
+
+        // The last span ids, oldest first
+        std::vector<std::uint32_t> tail() const {
+            std::vector<std::uint32_t> ids;
+            for (size_t back = size(); back > 0; --back) ids.push_back(recent[(seen - back) % recent.size()]);
+            return ids;
+        }
+    };
+
+    struct Gram {
+        std::uint64_t key;
+        std::uint64_t count;
+    };
+}
+
+// Bigram, trigram and windowed co-occurrence counts of a corpus, with the same tokenization as
+// WordData:
+//
+//     NgramStats stats("data/corpus.txt");
+//     long long n = stats.count("of", "the");
+//     for (auto& [word, count] : stats.topSuccessors("data", 5)) ...
+//     for (auto& [word, count] : stats.topCooccurring("tree", 10)) ...
+//
+// Built on the corpus ingestion pipeline: countCorpus gives the vocabulary and the unigram
+// counts, and the position of a word in it is its id. Every thread then tokenizes its chunk of
+// the mapped file again (Tokenizer, 1 MB at a time), turns the words into ids and counts the
+// n-grams ending at each word in its own tables, under packed 64-bit keys: two 32-bit ids for
+// pairs, three 21-bit ids for trigrams. The few n-grams that span two chunks are counted after
+// the threads join, from the first and last words of each chunk. The tables are merged in
+// parallel like countCorpus's, with thread p taking the keys whose first word(s) fall into
+// partition p, and each partition ends up with its keys grouped by first word(s), most frequent
+// first: top successors are a binary search plus k reads.
+//
+// Co-occurrence counts each unordered pair of distinct words at most window words apart,
+// once per occurrence; it is symmetric.
+//
+// With options.sketch the exact tables, whose size grows with the corpus, are replaced by
+// per-thread count-min sketches (merged by adding counters) and each thread keeps only the
+// options.candidates heaviest keys per kind (Misra-Gries). Counts are then estimates that are
+// never too low, and top-successor queries rank the candidates by their estimates, which finds
+// the frequent pairs but not the tail.
+class NgramStats {
+    using Gram = ngram_detail::Gram;
+
+    struct Partitioned {
+        std::vector<ngram_detail::GramTable> tables; // Exact mode: counts by key, per partition
+        std::vector<std::vector<Gram>> grams;        // By first word(s), then by count, descending
+    };
+
+    NgramOptions options;
+    std::vector<Word> words; // Sorted; the id of words[i] is i + 1
+    Partitioned kinds[ngram_detail::KindCount];
+    ngram_detail::CountMinSketch sketches[ngram_detail::KindCount];
+
+    std::uint32_t idOf(const std::string& word) const {
+        std::string key = WordData::normalize(word);
+        auto it = std::lower_bound(words.begin(), words.end(), key, [](const Word& w, const std::string& k) { return w.word < k; });
+        return it != words.end() && it->word == key ? static_cast<std::uint32_t>(it - words.begin() + 1) : 0;
+    }
+
+    long long countOf(ngram_detail::Kind kind, std::uint64_t key) const {
+        if (options.sketch) return static_cast<long long>(sketches[kind].estimate(key));
+        const Partitioned& part = kinds[kind];
+        if (part.tables.empty()) return 0;
+        const std::uint64_t group = key >> ngram_detail::groupShift(kind);
+        return static_cast<long long>(part.tables[group % part.tables.size()].count(key));
+    }
+
+    std::vector<std::pair<std::string, long long>> top(ngram_detail::Kind kind, std::uint64_t group, size_t k) const {
+        std::vector<std::pair<std::string, long long>> result;
+        const Partitioned& part = kinds[kind];
+        if (part.grams.empty()) return result;
+        const unsigned shift = ngram_detail::groupShift(kind);
+        const auto& grams = part.grams[group % part.grams.size()];
+        auto it = std::lower_bound(grams.begin(), grams.end(), group, [shift](const Gram& g, std::uint64_t v) { return (g.key >> shift) < v; });
+        const std::uint64_t mask = (std::uint64_t(1) << shift) - 1;
+        for (; it != grams.end() && (it->key >> shift) == group && result.size() < k; ++it)
+            result.emplace_back(words[(it->key & mask) - 1].word, static_cast<long long>(it->count));
+        return result;
+    }
+
+    // Thread p's share of the merge: the keys of every counter whose group is p modulo the
+    // partitions; a co-occurrence key is also filed under its second word, reversed
+    void mergePartition(ngram_detail::Kind kind, std::vector<ngram_detail::Counter>& counters, size_t p, size_t partitions) {
+        using namespace ngram_detail;
+        const unsigned shift = groupShift(kind);
+        size_t expected = 0;
+        for (const Counter& counter : counters) expected += counter.tables[kind].size();
+        GramTable merged(expected / partitions * (kind == Cooccurrence ? 2 : 1) + 16);
+        for (const Counter& counter : counters) {
+            for (const auto& entry : counter.tables[kind].slots()) {
+                if (!entry.key) continue;
+                if ((entry.key >> shift) % partitions == p) merged.add(entry.key, entry.count);
+                if (kind == Cooccurrence) {
+                    std::uint64_t reversed = entry.key << 32 | entry.key >> 32;
+                    if ((reversed >> shift) % partitions == p) merged.add(reversed, entry.count);
+                }
+            }
+        }
+        std::vector<Gram>& grams = kinds[kind].grams[p];
+        grams.reserve(merged.size());
+        for (const auto& entry : merged.slots()) {
+            if (!entry.key) continue;
+            std::uint64_t count = entry.count;
+            if (options.sketch) { // The candidates' own counts are Misra-Gries remainders
+                std::uint64_t key = kind == Cooccurrence ? bigramKey(static_cast<std::uint32_t>(std::min(entry.key >> 32, entry.key & 0xffffffff)),
+                    static_cast<std::uint32_t>(std::max(entry.key >> 32, entry.key & 0xffffffff))) : entry.key;
+                count = sketches[kind].estimate(key);
+            }
+            grams.push_back(Gram{ entry.key, count });
+        }
+        std::sort(grams.begin(), grams.end(), [shift](const Gram& a, const Gram& b) {
+            if ((a.key >> shift) != (b.key >> shift)) return (a.key >> shift) < (b.key >> shift);
+            return a.count != b.count ? a.count > b.count : a.key < b.key;
+            });
+        if (!options.sketch) kinds[kind].tables[p] = std::move(merged);
+    }
+
+public:
+    explicit NgramStats(const std::string& path, NgramOptions options = NgramOptions()) : options(options) {
+        using namespace ngram_detail;
+        words = countCorpus(path, options.threads);
+        if (options.trigrams && words.size() >= (1u << 21))
+            throw std::length_error("Too many distinct words for 21-bit trigram ids; set NgramOptions::trigrams to false");
+
+        corpus_detail::CountTable ids(words.size() * 2);
+        auto keep = [](std::string_view word) { return word; }; // Views into words, which stay put
+        for (size_t i = 0; i < words.size(); ++i) ids.add(corpus_detail::hashWord(words[i].word), words[i].word, i + 1, keep);
+
+        MappedFile file(path, true);
+        const char* data = file.data();
+        const std::vector<size_t> bounds = corpus_detail::splitChunks(data, file.size(), options.threads);
+        const size_t threads = bounds.size() - 1;
+        std::vector<Counter> counters(threads, Counter(this->options));
+        std::vector<Window> windows(threads, Window(this->options));
+
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t]() {
+                Tokenizer tokenizer;
+                auto push = [&](std::string_view word) {
+                    windows[t].push(static_cast<std::uint32_t>(ids.find(corpus_detail::hashWord(word), word)->count), counters[t]);
+                };
+                corpus_detail::forEachPiece(data, bounds[t], bounds[t + 1], [&](std::string_view piece) { tokenizer.forEachWord(piece, push); });
+                });
+        }
+        for (auto& thread : pool) thread.join();
+
+        // The n-grams that end in chunk t but start in an earlier one: the first words of the
+        // chunk against the last words before it
+        std::vector<std::uint32_t> context;
+        const size_t span = windows[0].span();
+        for (size_t t = 0; t < threads; ++t) {
+            const auto& head = windows[t].head;
+            for (size_t i = 0; i < head.size(); ++i) {
+                auto before = [&](size_t back) { return back <= i ? head[i - back] : context[context.size() - (back - i)]; };
+                const size_t reach = i + context.size(); // Words before head[i]
+                if (i == 0 && reach >= 1) counters[0].add(Bigram, bigramKey(before(1), head[i]));
+                if (i <= 1 && reach >= 2 && options.trigrams) counters[0].add(Trigram, trigramKey(before(2), before(1), head[i]));
+                for (size_t back = i + 1; back <= std::min<size_t>(options.window, reach); ++back) {
+                    std::uint32_t other = before(back);
+                    if (other != head[i]) counters[0].add(Cooccurrence, bigramKey(std::min(other, head[i]), std::max(other, head[i])));
+                }
+            }
+            if (windows[t].size() >= span) context = windows[t].tail();
+            else {
+                context.insert(context.end(), head.begin(), head.end());
+                if (context.size() > span) context.erase(context.begin(), context.end() - static_cast<std::ptrdiff_t>(span));
+            }
+        }
+
+        if (options.sketch) { // Sum the sketches, each thread a range of counters
+            for (int kind = 0; kind < KindCount; ++kind) sketches[kind] = std::move(counters[0].sketches[kind]);
+            pool.clear();
+            for (size_t p = 0; p < threads; ++p) {
+                pool.emplace_back([&, p]() {
+                    for (int kind = 0; kind < KindCount; ++kind) {
+                        const size_t cells = sketches[kind].cells();
+                        for (size_t t = 1; t < threads; ++t)
+                            sketches[kind].merge(counters[t].sketches[kind], cells / threads * p, p + 1 == threads ? cells : cells / threads * (p + 1));
+                    }
+                    });
+            }
+            for (auto& thread : pool) thread.join();
+        }
+
+        for (auto& part : kinds) {
+            part.grams.resize(threads);
+            if (!options.sketch) part.tables.resize(threads);
+        }
+        pool.clear();
+        for (size_t p = 0; p < threads; ++p) {
+            pool.emplace_back([&, p]() {
+                for (int kind = 0; kind < KindCount; ++kind) mergePartition(static_cast<Kind>(kind), counters, p, threads);
+                });
+        }
+        for (auto& thread : pool) thread.join();
+    }
+
+    size_t vocabularySize() const { return words.size(); }
+    bool approximate() const { return options.sketch; }
+
+    long long count(const std::string& word) const {
+        std::uint32_t a = idOf(word);
+        return a ? words[a - 1].frequency : 0;
+    }
+
+    long long count(const std::string& first, const std::string& second) const {
+        std::uint32_t a = idOf(first), b = idOf(second);
+        return a && b ? countOf(ngram_detail::Bigram, ngram_detail::bigramKey(a, b)) : 0;
+    }
+
+    long long count(const std::string& first, const std::string& second, const std::string& third) const {
+        std::uint32_t a = idOf(first), b = idOf(second), c = idOf(third);
+        return a && b && c && options.trigrams ? countOf(ngram_detail::Trigram, ngram_detail::trigramKey(a, b, c)) : 0;
+    }
+
+    // How often the two words occur at most window words apart, in either order
+    long long cooccurrences(const std::string& first, const std::string& second) const {
+        std::uint32_t a = idOf(first), b = idOf(second);
+        return a && b && a != b ? countOf(ngram_detail::Cooccurrence, ngram_detail::bigramKey(std::min(a, b), std::max(a, b))) : 0;
+    }
+
+    // The k words that most often follow word, with their counts, most frequent first
+    std::vector<std::pair<std::string, long long>> topSuccessors(const std::string& word, size_t k) const {
+        std::uint32_t a = idOf(word);
+        return a ? top(ngram_detail::Bigram, a, k) : std::vector<std::pair<std::string, long long>>();
+    }
+
+    // The k words that most often follow the two words
+    std::vector<std::pair<std::string, long long>> topSuccessors(const std::string& first, const std::string& second, size_t k) const {
+        std::uint32_t a = idOf(first), b = idOf(second);
+        return a && b && options.trigrams ? top(ngram_detail::Trigram, static_cast<std::uint64_t>(a) << 21 | b, k)
+            : std::vector<std::pair<std::string, long long>>();
+    }
+
+    // The k words that most often occur near word
+    std::vector<std::pair<std::string, long long>> topCooccurring(const std::string& word, size_t k) const {
+        std::uint32_t a = idOf(word);
+        return a ? top(ngram_detail::Cooccurrence, a, k) : std::vector<std::pair<std::string, long long>>();
+    }
+};
+
+#endif // NGRAM_STATS_HPP
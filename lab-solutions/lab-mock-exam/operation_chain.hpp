@@ -0,0 +1,451 @@
+#ifndef OPERATION_CHAIN_HPP
+#define OPERATION_CHAIN_HPP
+
+#include<iostream>
+#include<string>
+#include<cmath>
+#include<vector>
+#include<tuple>
+#include<utility>
+#include<type_traits>
+#include<algorithm>
+#include<thread>
+#include<stdexcept>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include<version>
+#endif
+#endif
+#if defined(__cpp_lib_span)
+#include<span>
+#endif
+
+namespace chain_detail {
+
+    // Fixed-length inner loops that the compiler turns into SIMD instructions (16 floats are
+    // four SSE or two AVX registers), and a scalar loop for the tail
+    constexpr size_t lanes = 16;
+
+    template<typename T, typename F>
+    void forEachElement(T* data, size_t n, F f) {
+        size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+            for (size_t j = 0; j < lanes; ++j) data[i + j] = f(data[i + j]);
+        for (; i < n; ++i) data[i] = f(data[i]);
+    }
+
+    // Splits n elements into one range per thread, none shorter than 32K elements: range c is
+    // [bounds[c], bounds[c + 1])
+    inline std::vector<size_t> splitRanges(size_t n, unsigned threads) {
+        size_t parts = std::max<size_t>(1, std::min<size_t>(threads, n / (1 << 15)));
+        std::vector<size_t> bounds(parts + 1);
+        for (size_t c = 0; c <= parts; ++c) bounds[c] = n / parts * c;
+        bounds[parts] = n;
+        return bounds;
+    }
+
+    // Calls f(c, begin, end) for every range, all but the first on threads of their own
+    template<typename F>
+    void forEachRange(const std::vector<size_t>& bounds, F f) {
+        std::vector<std::thread> pool;
+        for (size_t c = 1; c + 1 < bounds.size(); ++c) pool.emplace_back([&f, &bounds, c]() { f(c, bounds[c], bounds[c + 1]); });
+        f(0, bounds[0], bounds[1]);
+        for (auto& thread : pool) thread.join();
+    }
+
+    // Inclusive scan of data[0, n) continuing from carry, which ends as the last result. In
+    // parallel, every range scans on its own, the range totals are combined in order, and every
+    // range but the first then combines its elements with the total before it: the same
+    // results up to the rounding of the regrouped floating-point operations.
+    template<typename T, typename Combine>
+    void scan(T* data, size_t n, T& carry, unsigned threads, Combine combine) {
+        if (n == 0) return;
+        const std::vector<size_t> bounds = splitRanges(n, threads);
+        if (bounds.size() == 2) {
+            for (size_t i = 0; i < n; ++i) data[i] = carry = combine(carry, data[i]);
+            return;
+        }
+        forEachRange(bounds, [&](size_t c, size_t begin, size_t end) {
+            T running = c == 0 ? carry : data[begin];
+            for (size_t i = c == 0 ? begin : begin + 1; i < end; ++i) data[i] = running = combine(running, data[i]);
+            });
+        std::vector<T> totals(bounds.size() - 1);
+        totals[0] = data[bounds[1] - 1];
+        for (size_t c = 1; c < totals.size(); ++c) totals[c] = combine(totals[c - 1], data[bounds[c + 1] - 1]);
+        forEachRange(bounds, [&](size_t c, size_t begin, size_t end) {
+            if (c > 0) forEachElement(data + begin, end - begin, [&](T x) { return combine(totals[c - 1], x); });
+            });
+        carry = totals.back();
+    }
+
+    // The batch form of Power's and CachedSine's cache: elements at the start that equal the
+    // cached input get the cached output, as apply would return them, and the rest go through
+    // range(data, n), a pure function of the input; the cache ends on the last element
+    template<typename T, typename Range>
+    void cachedBatch(T* data, size_t n, unsigned threads, T& cachedInput, T& cachedOutput, Range range) {
+        size_t start = 0;
+        for (; start < n && data[start] == cachedInput; ++start) data[start] = cachedOutput;
+        if (start == n) return;
+        const T last = data[n - 1];
+        forEachRange(splitRanges(n - start, threads), [&](size_t, size_t begin, size_t end) { range(data + start + begin, end - begin); });
+        cachedInput = last;
+        cachedOutput = data[n - 1];
+    }
+}
+
+template<typename T>
+class Operation;
+
+// One step of a compiled chain: either the affine map input * scale + offset, computed in
+// place, or a plain function pointer that calls one operation's apply on its own state
+template<typename T>
+struct ChainStep {
+    T(*function)(void*, T) = nullptr; // nullptr for an affine step
+    void* operation = nullptr;
+    T scale = 1;
+    T offset = 0;
+
+    static ChainStep affine(T scale, T offset) { return ChainStep{ nullptr, nullptr, scale, offset }; }
+
+    // Calls Op::apply by name, so the call is direct (and inlined into invoke) rather than virtual
+    template<typename Op>
+    static ChainStep call(Op* op) { return ChainStep{ &invoke<Op>, op, 1, 0 }; }
+
+    // For operations the chain knows nothing about: apply through the vtable
+    static ChainStep dynamic(Operation<T>* op) { return ChainStep{ &invokeVirtual, op, 1, 0 }; }
+
+    T run(T input) const { return function ? function(operation, input) : input * scale + offset; }
+
+private:
+    template<typename Op>
+    static T invoke(void* op, T input) { return static_cast<Op*>(op)->Op::apply(input); }
+
+    static T invokeVirtual(void* op, T input) { return static_cast<Operation<T>*>(op)->apply(input); }
+};
+
+template<typename T>
+class Operation {
+public:
+    using value_type = T;
+    virtual T apply(T input) = 0;
+    virtual std::string name() = 0;
+    // This operation as a step of OperationChain::compile()
+    virtual ChainStep<T> compileStep() { return ChainStep<T>::dynamic(this); }
+    // Applies the operation to data[0, n) in place, with the results and final state of n calls
+    // to apply in order; threads > 1 allows the work to be split. The default calls apply.
+    virtual void applyBatch(T* data, size_t n, unsigned /*threads*/) {
+        for (size_t i = 0; i < n; ++i) data[i] = apply(data[i]);
+    }
+    virtual ~Operation() {}
+};
+
+template<typename T>
+class Add : public Operation<T> {
+    int value;
+public:
+    Add(int v) : value(v) {}
+    T apply(T input) override { return input + value; }
+    std::string name() override { return "Add"; }
+    ChainStep<T> compileStep() override { return ChainStep<T>::affine(1, static_cast<T>(value)); }
+    void applyBatch(T* data, size_t n, unsigned threads) override {
+        const int v = value;
+        chain_detail::forEachRange(chain_detail::splitRanges(n, threads), [&](size_t, size_t begin, size_t end) {
+            chain_detail::forEachElement(data + begin, end - begin, [v](T x) { return x + v; });
+            });
+    }
+};
+
+template<typename T>
+class Multiply : public Operation<T> {
+    T value;
+public:
+    Multiply(T v) : value(v) {}
+    T apply(T input) override { return input * value; }
+    std::string name() override { return "Multiply"; }
+    ChainStep<T> compileStep() override { return ChainStep<T>::affine(value, 0); }
+    void applyBatch(T* data, size_t n, unsigned threads) override {
+        const T v = value;
+        chain_detail::forEachRange(chain_detail::splitRanges(n, threads), [&](size_t, size_t begin, size_t end) {
+            chain_detail::forEachElement(data + begin, end - begin, [v](T x) { return x * v; });
+            });
+    }
+};
+
+// Expensive operation that takes time to compute, implement caching
+template<typename T>
+class Power : public Operation<T> {
+    T exponent;
+    T cached_input;
+    T cached_output;
+
+    // Handle negative exponent and positve both, not aalloed to use std::pow
+    T compute_power(T input, int _exponent_) {
+        if (_exponent_ == 0) return 1;
+        if (_exponent_ == 1) return input;
+        if (_exponent_ < 0) return 1 / compute_power(input, -_exponent_);
+        return input * compute_power(input, _exponent_ - 1);
+    }
+
+public:
+    Power(T exp) : exponent(exp), cached_input(0), cached_output(0) {}
+
+    T apply(T input) override {
+        if (input != cached_input) {
+            cached_output = compute_power(input, exponent);
+            cached_input = input;
+        }
+        return cached_output;
+    }
+
+    std::string name() override { return "Power"; }
+    ChainStep<T> compileStep() override { return ChainStep<T>::call(this); }
+
+    // compute_power over 16 elements at a time, with the multiplications in the same order
+    void applyBatch(T* data, size_t n, unsigned threads) override {
+        const int e = static_cast<int>(exponent);
+        const int steps = (e < 0 ? -e : e) - 1;
+        chain_detail::cachedBatch(data, n, threads, cached_input, cached_output, [this, e, steps](T* range, size_t count) {
+            if (e == 0) {
+                std::fill(range, range + count, T(1));
+                return;
+            }
+            constexpr size_t lanes = chain_detail::lanes;
+            size_t i = 0;
+            for (; i + lanes <= count; i += lanes) {
+                T x[lanes], r[lanes];
+                for (size_t j = 0; j < lanes; ++j) x[j] = r[j] = range[i + j];
+                for (int k = 0; k < steps; ++k)
+                    for (size_t j = 0; j < lanes; ++j) r[j] = x[j] * r[j];
+                for (size_t j = 0; j < lanes; ++j) range[i + j] = e < 0 ? 1 / r[j] : r[j];
+            }
+            for (; i < count; ++i) range[i] = compute_power(range[i], e);
+            });
+    }
+};
+
+
+template<typename T>
+class CachedSine : public Operation<T> {
+    T cached_input;
+    T cached_output;
+public:
+    CachedSine() : cached_input(0), cached_output(0) {}
+
+    T apply(T input) override {
+        if (input != cached_input) {
+            cached_output = sin(input);
+            cached_input = input;
+        }
+        return cached_output;
+    }
+
+    std::string name() override { return "CachedSine"; }
+    ChainStep<T> compileStep() override { return ChainStep<T>::call(this); }
+    void applyBatch(T* data, size_t n, unsigned threads) override {
+        chain_detail::cachedBatch(data, n, threads, cached_input, cached_output, [](T* range, size_t count) {
+            chain_detail::forEachElement(range, count, [](T x) { return static_cast<T>(sin(x)); });
+            });
+    }
+};
+
+template<typename T>
+class CachedAdd : public Operation<T> {
+    T cached_output;
+public:
+    CachedAdd() : cached_output(0) {}
+
+    T apply(T input) override {
+        cached_output += input;
+        return cached_output;
+    }
+
+    std::string name() override { return "CachedAdd"; }
+    ChainStep<T> compileStep() override { return ChainStep<T>::call(this); }
+    // The running sum is a prefix sum of the inputs
+    void applyBatch(T* data, size_t n, unsigned threads) override {
+        chain_detail::scan(data, n, cached_output, threads, [](T a, T b) { return a + b; });
+    }
+};
+
+template<typename T>
+class CachedMultiply : public Operation<T> {
+    T cached_output;
+public:
+    CachedMultiply() : cached_output(1) {}
+
+    T apply(T input) override {
+        cached_output *= input;
+        return cached_output;
+    }
+
+    std::string name() override { return "CachedMultiply"; }
+    ChainStep<T> compileStep() override { return ChainStep<T>::call(this); }
+    void applyBatch(T* data, size_t n, unsigned threads) override {
+        chain_detail::scan(data, n, cached_output, threads, [](T a, T b) { return a * b; });
+    }
+};
+
+template<typename T>
+class OperationNode {
+    Operation<T>* operation;
+    OperationNode* next;
+public:
+    OperationNode(Operation<T>* op) : operation(op), next(nullptr) {}
+
+    void setNext(OperationNode* nextNode) { next = nextNode; }
+
+    T apply(T input) { return operation->apply(input); }
+
+    OperationNode* getNext() { return next; }
+
+    std::string name() { return operation->name(); }
+
+    ChainStep<T> compileStep() { return operation->compileStep(); }
+
+    void applyBatch(T* data, size_t n, unsigned threads) { operation->applyBatch(data, n, threads); }
+
+    void clear() {
+        if (operation) delete operation;
+        operation = nullptr;
+    }
+
+};
+
+// A chain flattened into one contiguous array of steps, made by OperationChain::compile(). The
+// steps point at the chain's operations, so the cached ones keep a single state whichever of
+// the two applies them, and the compiled chain must not outlive the chain.
+template<typename T>
+class CompiledChain {
+    std::vector<ChainStep<T>> steps;
+
+public:
+    explicit CompiledChain(std::vector<ChainStep<T>> steps) : steps(std::move(steps)) {}
+
+    T apply(T input) const {
+        for (const ChainStep<T>& step : steps) input = step.run(input);
+        return input;
+    }
+
+    size_t size() const { return steps.size(); }
+};
+
+template<typename T>
+class OperationChain {
+    OperationNode<T>* head;
+    OperationNode<T>* tail;
+public:
+    OperationChain() : head(nullptr), tail(nullptr) {}
+
+    void addOperation(Operation<T>* operation) {
+        OperationNode<T>* newNode = new OperationNode<T>(operation);
+        if (!head) {
+            head = newNode;
+            tail = newNode;
+        }
+        else {
+            tail->setNext(newNode);
+            tail = newNode;
+        }
+    }
+
+    T apply(T input, bool verbose = true) {
+        OperationNode<T>* current = head;
+        if (verbose) std::cout << input;
+        while (current) {
+            input = current->apply(input);
+            current = current->getNext();
+            if (verbose) std::cout << " -> " << input;
+        }
+        if (verbose) std::cout << std::endl;
+        return input;
+    }
+
+    // Flattens the chain into a CompiledChain. With fuse, runs of Add and Multiply become one
+    // affine step: (x * a1 + b1) * a2 + b2 = x * (a1 * a2) + (b1 * a2 + b2). For floating point
+    // the fused result can differ from the chain's in the last bits.
+    CompiledChain<T> compile(bool fuse = true) {
+        std::vector<ChainStep<T>> steps;
+        for (OperationNode<T>* current = head; current; current = current->getNext()) {
+            ChainStep<T> step = current->compileStep();
+            if (fuse && !step.function && !steps.empty() && !steps.back().function) {
+                steps.back().offset = steps.back().offset * step.scale + step.offset;
+                steps.back().scale = steps.back().scale * step.scale;
+            }
+            else steps.push_back(step);
+        }
+        return CompiledChain<T>(std::move(steps));
+    }
+
+    // out[i] = apply(in[i], false) for i in [0, n), in order, so the cached operations end in the
+    // same state; in and out may be the same array. Every operation runs over a whole block at
+    // a time instead of every element walking the list: on one thread the blocks are 4096
+    // elements, which stay in cache from one operation to the next, and with more threads
+    // every operation splits the whole array between them. CachedAdd and CachedMultiply then
+    // regroup their sums and products, which for floating point changes the last bits.
+    void applyBatch(const T* in, T* out, size_t n, unsigned threads = 1) {
+        if (in != out) std::copy(in, in + n, out);
+        const size_t block = threads > 1 ? std::max<size_t>(n, 1) : 4096;
+        for (size_t begin = 0; begin < n; begin += block) {
+            const size_t count = std::min(block, n - begin);
+            for (OperationNode<T>* current = head; current; current = current->getNext())
+                current->applyBatch(out + begin, count, threads);
+        }
+    }
+
+#if defined(__cpp_lib_span)
+    void applyBatch(std::span<const T> in, std::span<T> out, unsigned threads = 1) {
+        if (out.size() < in.size()) throw std::invalid_argument("applyBatch: output is shorter than the input");
+        applyBatch(in.data(), out.data(), in.size(), threads);
+    }
+#endif
+
+    void printOperations() {
+        OperationNode<T>* current = head;
+        while (current) {
+            std::cout << current->name() << " -> ";
+            current = current->getNext();
+        }
+        std::cout << "End" << std::endl;
+    }
+
+    ~OperationChain() {
+        OperationNode<T>* current = head;
+        while (current) {
+            OperationNode<T>* next = current->getNext();
+            current->clear(); // Clear the operation
+            delete current;
+            current = next;
+        }
+    }
+};
+
+// A chain fixed at compile time: the operations are held by value in a std::tuple and applied
+// by a fold expression with calls by name, so there is no list to walk and no virtual call, and
+// the compiler can inline the whole chain into the caller's loop:
+//
+//     StaticChain chain(Add<float>(5), Multiply<float>(2), CachedSine<float>());
+//     float y = chain.apply(3);
+template<typename... Ops>
+class StaticChain {
+    static_assert(sizeof...(Ops) > 0, "a chain needs at least one operation");
+    std::tuple<Ops...> operations;
+
+public:
+    using value_type = typename std::tuple_element_t<0, std::tuple<Ops...>>::value_type;
+    static_assert((std::is_base_of_v<Operation<value_type>, Ops> && ...), "all operations must work on the same type");
+
+    explicit StaticChain(Ops... ops) : operations(std::move(ops)...) {}
+
+    value_type apply(value_type input) {
+        std::apply([&input](Ops&... ops) { ((input = ops.Ops::apply(input)), ...); }, operations);
+        return input;
+    }
+
+    void printOperations() {
+        std::apply([](Ops&... ops) { ((std::cout << ops.Ops::name() << " -> "), ...); }, operations);
+        std::cout << "End" << std::endl;
+    }
+};
+
+#endif // OPERATION_CHAIN_HPP
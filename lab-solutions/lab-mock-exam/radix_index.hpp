@@ -0,0 +1,254 @@
+#ifndef RADIX_INDEX_HPP
+#define RADIX_INDEX_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+
+
+// Compressed radix tree (Patricia trie) over words and their frequencies.
+//
+// Every edge holds a whole run of characters, so a node either ends a word or branches, and a
+// lookup costs O(|word|) character compares however many words are stored. The children of a
+// node are kept sorted by their first character, which makes the depth-first walk
+// alphabetical: the words starting with a prefix are the subtree below the prefix, found in
+// O(|prefix|) and listed in O(k) for k words.
+//
+// Every node also stores the largest frequency in its subtree. topK uses it for a best-first
+// search that expands only the subtrees that can still hold one of the k most frequent
+// completions, instead of listing every completion and sorting.
+class RadixIndex {
+    static constexpr int none = std::numeric_limits<int>::min();
+
+    // 32 bytes, and no allocation of its own: the tree lives in two arrays, nodes and labels
+    struct Node {
+        std::uint32_t labelStart = 0;    // The characters on the edge from the parent, in labels
+        std::uint32_t labelLength = 0;
+        std::uint32_t parent = 0;
+        std::uint32_t firstChild = 0;    // Children are a list sorted by first; 0 ends it
+        std::uint32_t nextSibling = 0;   // (the root is never anyone's child)
+        int frequency = 0;
+        int maxFrequency = none;         // Largest frequency in this subtree
+        unsigned char first = 0;         // First byte of the label
+        bool terminal = false;           // A word ends here
+    };
+
+    std::vector<Node> nodes{ Node() };   // nodes[0] is the root, for the empty string
+    std::string labels;                  // All edge labels; a split only moves offsets
+    size_t wordCount = 0;
+
+    std::string_view label(const Node& node) const { return std::string_view(labels).substr(node.labelStart, node.labelLength); }
+
+    // The child of node starting with c, or 0; previous is the last child before it, or 0.
+    // Bytes compare unsigned, as in std::string, so that the walk order matches the BST's.
+    std::uint32_t child(std::uint32_t node, char c, std::uint32_t& previous) const {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        previous = 0;
+        std::uint32_t current = nodes[node].firstChild;
+        while (current && nodes[current].first < byte) {
+            previous = current;
+            current = nodes[current].nextSibling;
+        }
+        return current && nodes[current].first == byte ? current : 0;
+    }
+
+    // Puts child where the list of parent had previous (0: at the front) followed by next
+    void link(std::uint32_t parent, std::uint32_t previous, std::uint32_t child, std::uint32_t next) {
+        nodes[child].parent = parent;
+        nodes[child].nextSibling = next;
+        if (previous) nodes[previous].nextSibling = child;
+        else nodes[parent].firstChild = child;
+    }
+
+    // Brings the subtree maxima from node up to the root in line with node's frequency
+    void propagate(std::uint32_t node, bool grew) {
+        if (grew) { // Raise the maxima until one already covers the new frequency
+            const int frequency = nodes[node].frequency;
+            for (std::uint32_t n = node; nodes[n].maxFrequency < frequency; n = nodes[n].parent) {
+                nodes[n].maxFrequency = frequency;
+                if (n == 0) break;
+            }
+            return;
+        }
+        for (std::uint32_t n = node;; n = nodes[n].parent) { // Recompute until a maximum is unchanged
+            Node& current = nodes[n];
+            int maximum = current.terminal ? current.frequency : none;
+            for (std::uint32_t c = current.firstChild; c; c = nodes[c].nextSibling) maximum = std::max(maximum, nodes[c].maxFrequency);
+            if (maximum == current.maxFrequency && n != node) break;
+            current.maxFrequency = maximum;
+            if (n == 0) break;
+        }
+    }
+
+    // The node whose path starts with prefix and is the shortest such path, with that path
+    struct Match {
+        std::uint32_t node;
+        std::string path;
+        bool found;
+    };
+
+    Match locate(std::string_view prefix) const {
+        Match match{ 0, std::string(), true };
+        size_t pos = 0;
+        while (pos < prefix.size()) {
+            std::uint32_t previous;
+            std::uint32_t next = child(match.node, prefix[pos], previous);
+            if (!next) return { 0, std::string(), false };
+            std::string_view edgeLabel = label(nodes[next]);
+            size_t common = std::min(edgeLabel.size(), prefix.size() - pos);
+            if (edgeLabel.substr(0, common) != prefix.substr(pos, common)) return { 0, std::string(), false };
+            match.node = next;
+            match.path += edgeLabel;
+            pos += common;
+        }
+        return match;
+    }
+
+    // Depth-first, alphabetical; path holds the word of node. Returns false once visitor stopped.
+    template <typename Visitor>
+    bool visit(std::uint32_t node, std::string& path, Visitor& visitor) const {
+        const Node& n = nodes[node];
+        if (n.terminal) {
+            if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, const std::string&, int>>) visitor(path, n.frequency);
+            else if (!visitor(path, n.frequency)) return false;
+        }
+        for (std::uint32_t c = n.firstChild; c; c = nodes[c].nextSibling) {
+            size_t length = path.size();
+            path += label(nodes[c]);
+            bool more = visit(c, path, visitor);
+            path.resize(length);
+            if (!more) return false;
+        }
+        return true;
+    }
+
+public:
+    // Adds count to the frequency of word, inserting it if needed, and returns the word's node,
+    // which stays the same for as long as the index lives
+    std::uint32_t add(std::string_view word, int count) {
+        std::uint32_t node = 0;
+        size_t pos = 0;
+        while (pos < word.size()) {
+            std::uint32_t previous;
+            std::uint32_t next = child(node, word[pos], previous);
+            if (!next) { // New leaf with the rest of the word
+                std::uint32_t leaf = static_cast<std::uint32_t>(nodes.size());
+                nodes.emplace_back();
+                nodes[leaf].labelStart = static_cast<std::uint32_t>(labels.size());
+                nodes[leaf].labelLength = static_cast<std::uint32_t>(word.size() - pos);
+                nodes[leaf].first = static_cast<unsigned char>(word[pos]);
+                labels.append(word.substr(pos));
+                link(node, previous, leaf, previous ? nodes[previous].nextSibling : nodes[node].firstChild);
+                node = leaf;
+                break;
+            }
+            std::string_view edgeLabel = label(nodes[next]);
+            size_t common = 1;
+            while (common < edgeLabel.size() && pos + common < word.size() && edgeLabel[common] == word[pos + common]) ++common;
+            if (common < edgeLabel.size()) { // The word leaves the edge midway: split it
+                std::uint32_t middle = static_cast<std::uint32_t>(nodes.size());
+                nodes.emplace_back();
+                Node& head = nodes[middle];
+                Node& tail = nodes[next];
+                head.labelStart = tail.labelStart;
+                head.labelLength = static_cast<std::uint32_t>(common);
+                head.first = tail.first;
+                head.maxFrequency = tail.maxFrequency;
+                tail.labelStart += static_cast<std::uint32_t>(common);
+                tail.labelLength -= static_cast<std::uint32_t>(common);
+                tail.first = static_cast<unsigned char>(labels[tail.labelStart]);
+                link(node, previous, middle, tail.nextSibling);
+                link(middle, 0, next, 0);
+                next = middle;
+            }
+            node = next;
+            pos += common;
+        }
+
+        Node& found = nodes[node];
+        if (!found.terminal) {
+            ++wordCount;
+            found.terminal = true;
+            propagate(node, false); // A new word: its own frequency counts from now on
+        }
+        addAt(node, count);
+        return node;
+    }
+
+    // Adds count to the frequency of the word at node (as returned by add) without looking the
+    // word up; an increase usually stops climbing within a level or two
+    void addAt(std::uint32_t node, int count) {
+        nodes[node].frequency += count;
+        propagate(node, count >= 0);
+    }
+
+    bool contains(std::string_view word) const {
+        Match match = locate(word);
+        return match.found && match.path.size() == word.size() && nodes[match.node].terminal;
+    }
+
+    // 0 for a word that is not in the index
+    int frequency(std::string_view word) const {
+        Match match = locate(word);
+        bool exact = match.found && match.path.size() == word.size() && nodes[match.node].terminal;
+        return exact ? nodes[match.node].frequency : 0;
+    }
+
+    // Streams the words starting with prefix, in alphabetical order, to
+    // visitor(const std::string& word, int frequency); a visitor returning false stops the walk
+    template <typename Visitor>
+    bool forEachWithPrefix(std::string_view prefix, Visitor visitor) const {
+        Match match = locate(prefix);
+        if (!match.found) return true;
+        return visit(match.node, match.path, visitor);
+    }
+
+    // The k most frequent words starting with prefix, most frequent first and alphabetical
+    // among equal frequencies
+    std::vector<std::pair<std::string, int>> topK(std::string_view prefix, size_t k) const {
+        std::vector<std::pair<std::string, int>> result;
+        Match match = locate(prefix);
+        if (!match.found || k == 0 || nodes[match.node].maxFrequency == none) return result;
+
+        // A candidate is a finished word or a subtree still to expand, ranked by the frequency
+        // it (at best) holds and then by its path; every word in a subtree sorts at or after
+        // the subtree's path, so a word is only taken once nothing before it can beat it
+        struct Candidate {
+            int frequency;
+            std::string path;
+            std::uint32_t node;
+            bool word;
+        };
+        auto later = [](const Candidate& a, const Candidate& b) {
+            if (a.frequency != b.frequency) return a.frequency < b.frequency;
+            if (a.path != b.path) return a.path > b.path;
+            return a.word && !b.word; // A subtree before its own word, which it expands into
+        };
+        std::priority_queue<Candidate, std::vector<Candidate>, decltype(later)> queue(later);
+        queue.push({ nodes[match.node].maxFrequency, std::move(match.path), match.node, false });
+
+        while (!queue.empty() && result.size() < k) {
+            Candidate top = queue.top();
+            queue.pop();
+            if (top.word) {
+                result.emplace_back(std::move(top.path), top.frequency);
+                continue;
+            }
+            const Node& n = nodes[top.node];
+            if (n.terminal) queue.push({ n.frequency, top.path, top.node, true });
+            for (std::uint32_t c = n.firstChild; c; c = nodes[c].nextSibling)
+                queue.push({ nodes[c].maxFrequency, top.path + std::string(label(nodes[c])), c, false });
+        }
+        return result;
+    }
+
+    size_t size() const { return wordCount; }
+};
+
+#endif // RADIX_INDEX_HPP
@@ -0,0 +1,187 @@
+#ifndef SIMD_TOKENIZER_HPP
+#define SIMD_TOKENIZER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_TOKENIZER_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMD_TOKENIZER_SSE2 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+
+namespace tokenizer_detail {
+
+    inline unsigned countTrailingZeros(std::uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+    }
+
+    struct Block {
+        std::uint64_t space;   // Bit i: byte i is whitespace
+        std::uint64_t letter;  // Bit i: byte i is an ASCII letter
+    };
+
+    // Classifies the 64 bytes at in and writes them to lowered with their letters in lower case
+    inline Block classify(const char* in, char* lowered) {
+        Block block{ 0, 0 };
+#if defined(SIMD_TOKENIZER_AVX2)
+        const __m256i blank = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t' - 1), cr = _mm256_set1_epi8('\r' + 1);
+        const __m256i caseBit = _mm256_set1_epi8(0x20), a = _mm256_set1_epi8('a' - 1), z = _mm256_set1_epi8('z' + 1);
+        for (int i = 0; i < 64; i += 32) {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            // Signed compares: bytes >= 0x80 are negative and fall outside both ranges
+            __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, blank),
+                _mm256_and_si256(_mm256_cmpgt_epi8(bytes, tab), _mm256_cmpgt_epi8(cr, bytes)));
+            __m256i folded = _mm256_or_si256(bytes, caseBit);
+            __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(folded, a), _mm256_cmpgt_epi8(z, folded));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lowered + i), _mm256_or_si256(bytes, _mm256_and_si256(letter, caseBit)));
+            block.space |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(space))) << i;
+            block.letter |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(letter))) << i;
+        }
+#elif defined(SIMD_TOKENIZER_SSE2)
+        const __m128i blank = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t' - 1), cr = _mm_set1_epi8('\r' + 1);
+        const __m128i caseBit = _mm_set1_epi8(0x20), a = _mm_set1_epi8('a' - 1), z = _mm_set1_epi8('z' + 1);
+        for (int i = 0; i < 64; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            // Signed compares: bytes >= 0x80 are negative and fall outside both ranges
+            __m128i space = _mm_or_si128(_mm_cmpeq_epi8(bytes, blank),
+                _mm_and_si128(_mm_cmpgt_epi8(bytes, tab), _mm_cmplt_epi8(bytes, cr)));
+            __m128i folded = _mm_or_si128(bytes, caseBit);
+            __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, a), _mm_cmplt_epi8(folded, z));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lowered + i), _mm_or_si128(bytes, _mm_and_si128(letter, caseBit)));
+            block.space |= static_cast<std::uint64_t>(_mm_movemask_epi8(space)) << i;
+            block.letter |= static_cast<std::uint64_t>(_mm_movemask_epi8(letter)) << i;
+        }
+#else
+        for (int i = 0; i < 64; ++i) {
+            char c = in[i];
+            bool space = c == ' ' || (c >= '\t' && c <= '\r');
+            bool letter = static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+            block.space |= static_cast<std::uint64_t>(space) << i;
+            block.letter |= static_cast<std::uint64_t>(letter) << i;
+            lowered[i] = letter ? static_cast<char>(c | 0x20) : c;
+        }
+#endif
+        return block;
+    }
+
+    // Bits [from, to) of a mask, 0 <= from <= to <= 64
+    inline std::uint64_t bits(std::uint64_t mask, unsigned from, unsigned to) {
+        std::uint64_t upto = to == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << to) - 1;
+        return mask & upto & (~std::uint64_t(0) << from);
+    }
+}
+
+// Splits text into WordData's words without istringstream or a copy per word:
+//
+//     Tokenizer tokenizer;
+//     for (std::string_view word : tokenizer.tokenize(text)) ...
+//
+// The rules are those of WordData's constructor: a token is a run of bytes other than the
+// whitespace istream >> skips (' ', '\t', '\n', '\v', '\f', '\r'), and its word is its ASCII
+// letters in lower case; tokens without letters are dropped.
+//
+// The text is classified 64 bytes at a time into a whitespace and a letter bit mask, 32 bytes
+// per instruction with AVX2, 16 with SSE2, or byte by byte where neither is available (the
+// choice is made at compile time, e.g. -mavx2). The same pass lowercases the block by OR-ing
+// 0x20 into its letters. Token boundaries are then found by counting trailing zeros of the
+// masks, and a token that is all letters, the usual case, is copied to the output arena with
+// one memcpy. The arena is reused from call to call and sized up front to the text, so the
+// returned views stay valid until the next call.
+class Tokenizer {
+    std::unique_ptr<char[]> arena;
+    size_t capacity = 0;
+    std::vector<std::string_view> words;
+
+public:
+    // Calls visitor(std::string_view word) for every word of text, in order, and returns the
+    // number of words. The views point into the arena and stay valid until the next call.
+    template <typename Visitor>
+    size_t forEachWord(std::string_view text, Visitor visitor) {
+        using namespace tokenizer_detail;
+        if (capacity < text.size() + 16) { // Words never outgrow their text; 16 bytes of slack
+            capacity = std::max(text.size() + 16, 2 * capacity);
+            arena.reset(new char[capacity]);
+        }
+        char* out = arena.get();
+        char* wordStart = out;
+        bool inToken = false;
+        size_t count = 0;
+
+        auto finish = [&]() {
+            if (out != wordStart) {
+                visitor(std::string_view(wordStart, static_cast<size_t>(out - wordStart)));
+                ++count;
+            }
+            inToken = false;
+        };
+
+        char padded[64], lowered[64 + 16] = {};
+        for (size_t offset = 0; offset < text.size(); offset += 64) {
+            const char* in = text.data() + offset;
+            const unsigned length = static_cast<unsigned>(std::min<size_t>(64, text.size() - offset));
+            if (length < 64) { // The tail, padded with spaces
+                std::memset(padded, ' ', sizeof(padded));
+                std::memcpy(padded, in, length);
+                in = padded;
+            }
+            Block block = classify(in, lowered);
+
+            unsigned i = 0;
+            while (i < 64) {
+                if (!inToken) {
+                    std::uint64_t rest = ~block.space & (~std::uint64_t(0) << i);
+                    if (!rest) break;
+                    i = countTrailingZeros(rest);
+                    inToken = true;
+                    wordStart = out;
+                }
+                std::uint64_t spaces = block.space & (~std::uint64_t(0) << i);
+                unsigned end = spaces ? countTrailingZeros(spaces) : 64;
+                std::uint64_t letters = bits(block.letter, i, end);
+                if (letters == bits(~std::uint64_t(0), i, end)) { // All letters
+                    // A fixed-size copy of a short run compiles to one move; the bytes past it
+                    // land in the slack or are overwritten by the next word
+                    if (end - i <= 16) std::memcpy(out, lowered + i, 16);
+                    else std::memcpy(out, lowered + i, end - i);
+                    out += end - i;
+                }
+                else {
+                    for (; letters; letters &= letters - 1) *out++ = lowered[countTrailingZeros(letters)];
+                }
+                i = end;
+                if (i < 64) finish();
+            }
+        }
+        if (inToken) finish();
+        return count;
+    }
+
+    // The words of text; the vector and the views are valid until the next call
+    const std::vector<std::string_view>& tokenize(std::string_view text) {
+        words.clear();
+        forEachWord(text, [this](std::string_view word) { words.push_back(word); });
+        return words;
+    }
+};
+
+#endif // SIMD_TOKENIZER_HPP
@@ -0,0 +1,429 @@
+#ifndef WORD_DATA_HPP
+#define WORD_DATA_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <iomanip>
+#include <type_traits>
+#include <string_view>
+#include <cstring>
+#include <cctype>
+#include <memory>
+#include <queue>
+
+#include "radix_index.hpp"
+#include "simd_tokenizer.hpp"
+#include "frequency_buckets.hpp"
+#include "word_index_file.hpp"
+
+struct Word {
+    std::string word;
+    int frequency;
+
+    Word(const std::string& w, int f) : word(w), frequency(f) {}
+
+    bool operator<(const Word& other) const { return word < other.word; }
+    bool operator>(const Word& other) const { return word > other.word; }
+    bool operator==(const Word& other) const { return word == other.word; }
+
+    Word& operator++() {
+        ++frequency;
+        return *this;
+    }
+
+    Word operator--() {
+        --frequency;
+        return *this;
+    }
+};
+
+
+class WordData {
+    int total_word_count; // Total word count in the corpus
+    int unique_word_count; // Unique word count in the corpus
+
+    struct Node {
+        Word word;
+        Node* left;
+        Node* right;
+        std::uint32_t indexNode;          // The word's node in index
+        FrequencyBuckets::Entry position; // The word's place in frequencies
+        Node(const Word& w) : word(w), left(nullptr), right(nullptr) {}
+    };
+
+    Node* root;
+    RadixIndex index; // Same words and frequencies as the tree, for exact and prefix lookups
+    FrequencyBuckets frequencies; // The words of the nodes by frequency and by length
+    std::unique_ptr<WordIndexFile> mapped; // Set by openIndex until the first insert; answers every query
+private:
+    void insert(Node*& node, const Word& word) {
+        if (!node) {
+            node = new Node(word);
+            ++unique_word_count;
+            total_word_count += word.frequency;
+            node->indexNode = index.add(word.word, word.frequency);
+            frequencies.insert(node->position, node->word.word, word.frequency);
+        }
+        else if (word < node->word) insert(node->left, word);
+        else if (word > node->word) insert(node->right, word);
+        else {
+            node->word.frequency += word.frequency;
+            total_word_count += word.frequency;
+            index.addAt(node->indexNode, word.frequency);
+            frequencies.add(node->position, word.frequency);
+        }
+    }
+
+    void cleanUp(Node* node) {
+        if (!node) return;
+        cleanUp(node->left);
+        cleanUp(node->right);
+        delete node;
+    }
+
+    Node* find(Node* node, const std::string& word) const {
+        if (!node) return nullptr;
+        if (word < node->word.word) return find(node->left, word);
+        else if (word > node->word.word) return find(node->right, word);
+        else return node;
+    }
+
+    Node* prefixSearch(Node* node, const std::string& prefix) const {
+        if (!node) return nullptr;
+        else if (node->word.word.compare(0, prefix.size(), prefix) < 0) return prefixSearch(node->right, prefix);
+        else if (node->word.word.compare(0, prefix.size(), prefix) > 0) return prefixSearch(node->left, prefix);
+        else return node;
+    }
+
+    // In-order walk of the words starting with prefix: subtrees entirely before or after the
+    // prefix range are skipped. Returns false once visitor asked to stop.
+    template <typename Visitor>
+    bool forEachStartingWith(Node* node, const std::string& prefix, Visitor& visitor) const {
+        if (!node) return true;
+        int order = node->word.word.compare(0, prefix.size(), prefix);
+        if (order < 0) return forEachStartingWith(node->right, prefix, visitor);
+        if (order > 0) return forEachStartingWith(node->left, prefix, visitor);
+        if (!forEachStartingWith(node->left, prefix, visitor)) return false;
+        if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, const Word&>>) visitor(node->word);
+        else if (!visitor(node->word)) return false;
+        return forEachStartingWith(node->right, prefix, visitor);
+    }
+
+    void inOrder(Node* node, std::function<void(const Word&)> func) const {
+        if (!node) return;
+        inOrder(node->left, func);
+        func(node->word);
+        inOrder(node->right, func);
+    }
+
+    void postOrder(Node* node, std::function<void(const Word&)> func) const {
+        if (!node) return;
+        postOrder(node->left, func);
+        postOrder(node->right, func);
+        func(node->word);
+    }
+
+    void preOrder(Node* node, std::function<void(const Word&)> func) const {
+        if (!node) return;
+        func(node->word);
+        preOrder(node->left, func);
+        preOrder(node->right, func);
+    }
+
+    // The mapped words [lo, hi) in the order of the tree insertSorted would build from them
+    void mappedOrder(size_t lo, size_t hi, bool pre, const std::function<void(const Word&)>& func) const {
+        if (lo == hi) return;
+        size_t mid = lo + (hi - lo) / 2;
+        if (pre) func(Word(mapped->word(mid), mapped->frequency(mid)));
+        mappedOrder(lo, mid, pre, func);
+        mappedOrder(mid + 1, hi, pre, func);
+        if (!pre) func(Word(mapped->word(mid), mapped->frequency(mid)));
+    }
+
+    // Moves the mapped words into the tree, before the first change
+    void loadMapped() {
+        if (!mapped) return;
+        std::unique_ptr<WordIndexFile> file = std::move(mapped);
+        std::vector<Word> words;
+        words.reserve(file->size());
+        file->forEachFrom(0, [&](std::string_view word, int frequency) { words.emplace_back(std::string(word), frequency); });
+        insertSorted(words);
+    }
+
+    explicit WordData(std::unique_ptr<WordIndexFile> file) : total_word_count(0), unique_word_count(0), root(nullptr), mapped(std::move(file)) {}
+
+
+public:
+    // Empty word data, to be filled with insert or insertSorted (see corpus_ingest.hpp)
+    WordData() : total_word_count(0), unique_word_count(0), root(nullptr) {}
+
+    // Reads the file in 1 MB blocks and splits each block with the vectorized Tokenizer; a
+    // word cut by the end of a block is carried over to the next one
+    WordData(const std::string& filePath) : root(nullptr), total_word_count(0), unique_word_count(0) {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open()) throw std::runtime_error("Could not open file: " + filePath);
+
+        Tokenizer tokenizer;
+        std::vector<char> buffer(1 << 20);
+        size_t kept = 0; // Bytes carried over from the previous block
+        for (;;) {
+            file.read(buffer.data() + kept, static_cast<std::streamsize>(buffer.size() - kept));
+            size_t filled = kept + static_cast<size_t>(file.gcount());
+            bool end = !file;
+            size_t cut = filled;
+            if (!end) { // Stop after the last whitespace so that no word is split
+                while (cut > 0 && !std::isspace(static_cast<unsigned char>(buffer[cut - 1]))) --cut;
+                if (cut == 0) { // One token fills the buffer
+                    kept = filled;
+                    buffer.resize(buffer.size() * 2);
+                    continue;
+                }
+            }
+            tokenizer.forEachWord(std::string_view(buffer.data(), cut),
+                [this](std::string_view word) { insert(root, Word(std::string(word), 1)); });
+            if (end) break;
+            kept = filled - cut;
+            std::memmove(buffer.data(), buffer.data() + cut, kept);
+        }
+        file.close();
+    }
+
+    ~WordData() { cleanUp(root); }
+
+    // Opens a file written by exportIndex without reading it: the file is mapped and every
+    // query is answered from the mapped pages. The first insert copies the words into the tree
+    // (and indexes), after which the word data is an ordinary in-memory one.
+    static WordData openIndex(const std::string& path) { return WordData(std::make_unique<WordIndexFile>(path)); }
+
+    // Writes the words in the binary format of word_index_file.hpp
+    void exportIndex(const std::string& path) const {
+        WordIndexWriter writer;
+        inOrder([&writer](const Word& word) { writer.add(word.word, word.frequency); });
+        writer.write(path);
+    }
+
+
+    void insert(const Word& word) {
+        loadMapped();
+        insert(root, word);
+    }
+
+    // Inserts words sorted alphabetically, middle first: every range inserts its median before
+    // its two halves, so the tree comes out balanced (depth log2 n) instead of a sorted-order
+    // linked list.
+    void insertSorted(const std::vector<Word>& words) {
+        loadMapped();
+        std::vector<std::pair<size_t, size_t>> ranges{ { 0, words.size() } };
+        for (size_t next = 0; next < ranges.size(); ++next) {
+            auto [lo, hi] = ranges[next];
+            if (lo == hi) continue;
+            size_t mid = lo + (hi - lo) / 2;
+            insert(root, words[mid]);
+            ranges.emplace_back(lo, mid);
+            ranges.emplace_back(mid + 1, hi);
+        }
+    }
+
+    void inOrder(std::function<void(const Word&)> func) const {
+        if (mapped) mapped->forEachFrom(0, [&](std::string_view word, int frequency) { func(Word(std::string(word), frequency)); });
+        else inOrder(root, func);
+    }
+
+    void postOrder(std::function<void(const Word&)> func) const {
+        if (mapped) mappedOrder(0, mapped->size(), false, func);
+        else postOrder(root, func);
+    }
+
+    void preOrder(std::function<void(const Word&)> func) const {
+        if (mapped) mappedOrder(0, mapped->size(), true, func);
+        else preOrder(root, func);
+    }
+
+    std::string prefixSearch(const std::string& prefix) const {
+        if (mapped) {
+            std::string key = normalize(prefix);
+            size_t id = mapped->lowerBound(key);
+            std::string word = id < mapped->size() ? mapped->word(id) : "";
+            return word.compare(0, key.size(), key) == 0 ? word : "";
+        }
+        Node* node = prefixSearch(root, normalize(prefix));
+        if (!node) return ""; // No match found
+        return node->word.word; // Return the first word that matches the prefix
+    }
+
+    std::string find(const std::string& word) const {
+        if (mapped) {
+            size_t id = mapped->find(normalize(word));
+            return id < mapped->size() ? mapped->word(id) : "";
+        }
+        Node* node = find(root, normalize(word));
+        if (!node) return ""; // No match found
+        return node->word.word; // Return the word if found
+    }
+
+    int getFrequency(const std::string& word) const {
+        if (mapped) {
+            size_t id = mapped->find(normalize(word));
+            return id < mapped->size() ? mapped->frequency(id) : 0;
+        }
+        return index.frequency(normalize(word));
+    }
+
+    bool containsWord(const std::string& word) const {
+        if (mapped) return mapped->find(normalize(word)) < mapped->size();
+        return index.contains(normalize(word));
+    }
+
+    int getTotalWordCount() const { return mapped ? static_cast<int>(mapped->totalCount()) : total_word_count; }
+    int getUniqueWordCount() const { return mapped ? static_cast<int>(mapped->size()) : unique_word_count; }
+
+    void exportToFile(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file.is_open()) throw std::runtime_error("Could not open file: " + path);
+
+        auto writeWord = [&file](const Word& word) { file << std::left << std::setw(20) << word.word << word.frequency << "\n";};
+        inOrder(writeWord);
+        file.close();
+    }
+
+    static std::string normalize(const std::string& word) {
+        std::string normalized = word;
+        normalized.erase(std::remove_if(normalized.begin(), normalized.end(), [](char c) { return !std::isalpha(c); }), normalized.end());
+        std::transform(normalized.begin(), normalized.end(), normalized.begin(), ::tolower);
+        return normalized;
+    }
+
+    // Streams the words starting with prefix, in alphabetical order, to visitor(const Word&)
+    // without building a vector. If the visitor returns a bool, false stops the search, e.g.
+    // after the first k completions.
+    template <typename Visitor>
+    bool for_each_starting_with(const std::string& prefix, Visitor visitor) const {
+        if (mapped) {
+            std::string key = normalize(prefix);
+            bool completed = true;
+            mapped->forEachFrom(mapped->lowerBound(key), [&](std::string_view word, int frequency) {
+                if (word.compare(0, key.size(), key) != 0) return false;
+                Word current{ std::string(word), frequency };
+                if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, const Word&>>) visitor(current);
+                else if (!visitor(current)) return completed = false;
+                return true;
+                });
+            return completed;
+        }
+        return forEachStartingWith(root, normalize(prefix), visitor);
+    }
+
+    // O(|prefix| + k) for k matches, through the radix index
+    std::vector<std::string> starts_with(const std::string& prefix) const {
+        std::vector<std::string> result;
+        if (mapped) { // A range of consecutive ids, decoded block by block
+            std::string key = normalize(prefix);
+            mapped->forEachFrom(mapped->lowerBound(key), [&](std::string_view word, int) {
+                if (word.compare(0, key.size(), key) != 0) return false;
+                result.emplace_back(word);
+                return true;
+                });
+            return result;
+        }
+        index.forEachWithPrefix(normalize(prefix), [&](const std::string& word, int) { result.push_back(word); });
+        return result;
+    }
+
+    // Autocomplete: the k most frequent words starting with prefix, most frequent first
+    std::vector<std::string> top_k_starting_with(const std::string& prefix, int k) const {
+        std::vector<std::string> result;
+        if (mapped) { // The file has no per-prefix order: a bounded heap over the range
+            if (k <= 0) return result;
+            std::string key = normalize(prefix);
+            using Entry = std::pair<int, std::string>;
+            auto better = [](const Entry& a, const Entry& b) { return a.first != b.first ? a.first > b.first : a.second < b.second; };
+            std::priority_queue<Entry, std::vector<Entry>, decltype(better)> heap(better); // Worst of the best k on top
+            mapped->forEachFrom(mapped->lowerBound(key), [&](std::string_view word, int frequency) {
+                if (word.compare(0, key.size(), key) != 0) return false;
+                if (static_cast<int>(heap.size()) < k) heap.emplace(frequency, std::string(word));
+                else if (frequency > heap.top().first) { // Later words lose ties
+                    heap.pop();
+                    heap.emplace(frequency, std::string(word));
+                }
+                return true;
+                });
+            for (; !heap.empty(); heap.pop()) result.push_back(heap.top().second);
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+        for (auto& [word, frequency] : index.topK(normalize(prefix), static_cast<size_t>(std::max(k, 0)))) result.push_back(word);
+        return result;
+    }
+
+    // O(1) to find, plus one copy per word returned
+    std::vector<std::string> most_frequent() const {
+        std::vector<std::string> result;
+        if (mapped) {
+            for (size_t rank = 0; rank < mapped->size(); ++rank) {
+                size_t id = mapped->idByFrequency(rank);
+                if (mapped->frequency(id) != mapped->frequency(mapped->idByFrequency(0))) break;
+                result.push_back(mapped->word(id));
+            }
+            return result;
+        }
+        frequencies.forEachWithMaxFrequency([&](std::string_view word, int) { result.emplace_back(word); });
+        return result;
+    }
+
+    std::vector<std::string> longest_word() const {
+        if (mapped) {
+            std::vector<std::string> result;
+            for (size_t i = 0; i < mapped->longestCount(); ++i) result.push_back(mapped->word(mapped->longestId(i)));
+            return result;
+        }
+        std::vector<std::string> result;
+        frequencies.forEachLongest([&](std::string_view word, size_t) { result.emplace_back(word); });
+        return result;
+    }
+
+    // Read off the frequency buckets (or the file's frequency order); ties alphabetically, in
+    // memory and mapped alike
+    std::vector<std::string> top_k(int k) const {
+        std::vector<std::string> result;
+        if (k <= 0) return result;
+        if (mapped) { // The file keeps the ids in frequency order
+            for (size_t rank = 0; rank < mapped->size() && static_cast<int>(rank) < k; ++rank)
+                result.push_back(mapped->word(mapped->idByFrequency(rank)));
+            return result;
+        }
+        frequencies.forEachMostFrequent([&](std::string_view word, int) {
+            result.emplace_back(word);
+            return static_cast<int>(result.size()) < k;
+            });
+        return result;
+    }
+
+    std::vector<std::string> bottom_k(int k) const {
+        std::vector<std::string> result;
+        if (k <= 0) return result;
+        if (mapped) { // Frequency groups from the back of the order, each read forwards
+            for (size_t end = mapped->size(); end > 0 && static_cast<int>(result.size()) < k;) {
+                const int frequency = mapped->frequency(mapped->idByFrequency(end - 1));
+                size_t begin = end - 1;
+                while (begin > 0 && mapped->frequency(mapped->idByFrequency(begin - 1)) == frequency) --begin;
+                for (size_t rank = begin; rank < end && static_cast<int>(result.size()) < k; ++rank)
+                    result.push_back(mapped->word(mapped->idByFrequency(rank)));
+                end = begin;
+            }
+            return result;
+        }
+        frequencies.forEachLeastFrequent([&](std::string_view word, int) {
+            result.emplace_back(word);
+            return static_cast<int>(result.size()) < k;
+            });
+        return result;
+    }
+
+};
+
+#endif // WORD_DATA_HPP
@@ -0,0 +1,303 @@
+#ifndef WORD_INDEX_FILE_HPP
+#define WORD_INDEX_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "mapped_file.hpp"
+
+
+namespace word_index_detail {
+
+    constexpr char magic[8] = { 'W', 'O', 'R', 'D', 'I', 'D', 'X', '1' };
+    constexpr std::uint32_t byteOrderTag = 0x01020304;
+    constexpr std::uint32_t blockSize = 16;
+
+    struct Header {
+        char magic[8];
+        std::uint32_t byteOrder;
+        std::uint32_t blockSize;
+        std::uint64_t wordCount;
+        std::uint64_t totalCount;   // Sum of the frequencies
+        std::uint64_t blockCount;
+        std::uint64_t poolSize;
+        std::uint64_t longestCount;
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(Header) == 64, "the header is part of the file format");
+
+    inline void putVarint(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    inline std::uint64_t getVarint(const char*& in) {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            std::uint8_t byte = static_cast<std::uint8_t>(*in++);
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (byte < 0x80) return value;
+        }
+    }
+
+    template <typename T>
+    void writeArray(std::ofstream& file, const std::vector<T>& values) {
+        file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+}
+
+// A compact binary form of a word table that is opened by mapping it, not by parsing it:
+//
+//     WordIndexWriter writer;
+//     for (...) writer.add(word, frequency);  // Strictly increasing words
+//     writer.write("words.idx");
+//
+//     WordIndexFile index("words.idx");        // One mmap and a few header checks
+//     int n = index.frequency(index.find("data"));
+//
+// Layout, in the byte order of the machine that wrote it, every section naturally aligned:
+//
+//     Header          magic, byte order tag, counts and sizes (64 bytes)
+//     block offsets   uint64 per block: where the block starts in the pool
+//     frequencies     int32 per word, in word order
+//     by frequency    uint32 word ids, most frequent first, ties in word order
+//     longest         uint32 ids of the words of the greatest length
+//     pool            the words, front coded in blocks of 16
+//
+// Front coding: the first word of a block is stored whole (varint length, bytes) and every
+// other word as the length of the prefix it shares with the word before it and the rest
+// (varint, varint, bytes). Sorted words share long prefixes, so the pool is usually well under
+// the size of the words, and a lookup binary searches the block heads, which are plain
+// strings in the mapping, then decodes at most one block. Nothing is read or built on open, so
+// the cost is the mmap and the first touch of the pages a query needs.
+//
+// A minimal perfect hash would answer exact lookups in O(1), but would not help prefix queries
+// and would need its own construction pass; with 16-word blocks the binary search touches
+// log2(n / 16) heads, the top of which stay cached.
+//
+// The sizes of the sections are checked against the file on open; the contents are trusted
+// like those of the text export.
+//
+// Word ids are positions in alphabetical order.
+class WordIndexFile {
+    MappedFile file;
+    word_index_detail::Header header;
+    const std::uint64_t* blocks = nullptr;
+    const std::int32_t* frequencies = nullptr;
+    const std::uint32_t* byFrequency = nullptr;
+    const std::uint32_t* longestIds = nullptr;
+    const char* pool = nullptr;
+
+    // The first word of a block, straight from the mapping
+    std::string_view head(size_t block) const {
+        const char* in = pool + blocks[block];
+        size_t length = static_cast<size_t>(word_index_detail::getVarint(in));
+        return std::string_view(in, length);
+    }
+
+    // Last block whose first word is <= key, or 0
+    size_t blockOf(std::string_view key) const {
+        size_t lo = 0, hi = header.blockCount;
+        while (hi - lo > 1) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (head(mid) <= key) lo = mid;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    // Decodes the words of block from position `from` on into word, calling
+    // visitor(size_t id, const std::string& word) until it returns false; false if it did
+    template <typename Visitor>
+    bool decodeBlock(size_t block, size_t from, std::string& word, Visitor& visitor) const {
+        using namespace word_index_detail;
+        const char* in = pool + blocks[block];
+        const size_t first = block * blockSize;
+        const size_t count = std::min<size_t>(blockSize, header.wordCount - first);
+        for (size_t i = 0; i < count; ++i) {
+            if (i == 0) {
+                size_t length = static_cast<size_t>(getVarint(in));
+                word.assign(in, length);
+                in += length;
+            }
+            else {
+                size_t shared = static_cast<size_t>(getVarint(in));
+                size_t rest = static_cast<size_t>(getVarint(in));
+                word.resize(shared);
+                word.append(in, rest);
+                in += rest;
+            }
+            if (i >= from && !visitor(first + i, word)) return false;
+        }
+        return true;
+    }
+
+public:
+    explicit WordIndexFile(const std::string& path) : file(path) {
+        using namespace word_index_detail;
+        auto invalid = [&path]() { return std::runtime_error("Not a word index file: " + path); };
+        if (file.size() < sizeof(Header)) throw invalid();
+        std::memcpy(&header, file.data(), sizeof(Header));
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) throw invalid();
+        if (header.byteOrder != byteOrderTag) throw std::runtime_error("Word index file written with another byte order: " + path);
+        if (header.wordCount > file.size() || header.poolSize > file.size()) throw invalid(); // Keeps the sums below from overflowing
+        if (header.blockSize != blockSize || header.blockCount != (header.wordCount + blockSize - 1) / blockSize
+            || header.longestCount > header.wordCount || (header.wordCount > 0) != (header.longestCount > 0)) throw invalid();
+        const std::uint64_t expected = sizeof(Header) + header.blockCount * sizeof(std::uint64_t)
+            + header.wordCount * (sizeof(std::int32_t) + sizeof(std::uint32_t))
+            + header.longestCount * sizeof(std::uint32_t) + header.poolSize;
+        if (expected != file.size()) throw invalid();
+
+        // Every section starts at a multiple of its element size, and so does the mapping
+        const char* at = file.data() + sizeof(Header);
+        blocks = reinterpret_cast<const std::uint64_t*>(at);
+        at += header.blockCount * sizeof(std::uint64_t);
+        frequencies = reinterpret_cast<const std::int32_t*>(at);
+        at += header.wordCount * sizeof(std::int32_t);
+        byFrequency = reinterpret_cast<const std::uint32_t*>(at);
+        at += header.wordCount * sizeof(std::uint32_t);
+        longestIds = reinterpret_cast<const std::uint32_t*>(at);
+        at += header.longestCount * sizeof(std::uint32_t);
+        pool = at;
+    }
+
+    WordIndexFile(const WordIndexFile&) = delete;
+    WordIndexFile& operator=(const WordIndexFile&) = delete;
+
+    size_t size() const { return static_cast<size_t>(header.wordCount); }
+    long long totalCount() const { return static_cast<long long>(header.totalCount); }
+    int frequency(size_t id) const { return frequencies[id]; }
+
+    // The id of the first word >= key, size() if there is none
+    size_t lowerBound(std::string_view key) const {
+        if (header.wordCount == 0) return 0;
+        size_t block = blockOf(key);
+        size_t found = std::min<size_t>((block + 1) * word_index_detail::blockSize, size());
+        std::string word;
+        auto stopAtKey = [&](size_t id, const std::string& w) {
+            if (w < key) return true;
+            found = id;
+            return false;
+        };
+        decodeBlock(block, 0, word, stopAtKey);
+        return found;
+    }
+
+    // The id of word, size() if it is not in the index
+    size_t find(std::string_view word) const {
+        size_t id = lowerBound(word);
+        return id < size() && this->word(id) == word ? id : size();
+    }
+
+    std::string word(size_t id) const {
+        std::string word;
+        auto stop = [](size_t, const std::string&) { return false; };
+        decodeBlock(id / word_index_detail::blockSize, id % word_index_detail::blockSize, word, stop);
+        return word;
+    }
+
+    // Streams the words from id on, in alphabetical order, to visitor(std::string_view word,
+    // int frequency); a visitor that returns false stops the walk
+    template <typename Visitor>
+    void forEachFrom(size_t id, Visitor visitor) const {
+        std::string word;
+        auto call = [&](size_t at, const std::string& w) {
+            if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::string_view, int>>) {
+                visitor(std::string_view(w), frequencies[at]);
+                return true;
+            }
+            else return static_cast<bool>(visitor(std::string_view(w), frequencies[at]));
+        };
+        for (size_t block = id / word_index_detail::blockSize; block < header.blockCount; ++block) {
+            size_t from = block == id / word_index_detail::blockSize ? id % word_index_detail::blockSize : 0;
+            if (!decodeBlock(block, from, word, call)) return;
+        }
+    }
+
+    // The id of the word at rank in frequency order, 0 being the most frequent
+    size_t idByFrequency(size_t rank) const { return byFrequency[rank]; }
+
+    size_t longestCount() const { return static_cast<size_t>(header.longestCount); }
+    size_t longestId(size_t i) const { return longestIds[i]; }
+};
+
+// Collects words in strictly increasing order and writes them as a WordIndexFile
+class WordIndexWriter {
+    std::string pool;
+    std::vector<std::uint64_t> blocks;
+    std::vector<std::int32_t> frequencies;
+    std::vector<std::uint32_t> longest;
+    std::string previous;
+    size_t longestLength = 0;
+    std::uint64_t totalCount = 0;
+
+public:
+    void add(std::string_view word, int frequency) {
+        using namespace word_index_detail;
+        const size_t id = frequencies.size();
+        if (id > 0 && word <= previous) throw std::invalid_argument("Words must be added in strictly increasing order: " + std::string(word));
+        if (id >= UINT32_MAX) throw std::length_error("Too many words for the index format");
+        if (id % blockSize == 0) {
+            blocks.push_back(pool.size());
+            putVarint(pool, word.size());
+            pool.append(word);
+        }
+        else {
+            size_t shared = std::mismatch(word.begin(), word.begin() + std::min(word.size(), previous.size()), previous.begin()).first - word.begin();
+            putVarint(pool, shared);
+            putVarint(pool, word.size() - shared);
+            pool.append(word.substr(shared));
+        }
+        previous.assign(word);
+        frequencies.push_back(frequency);
+        totalCount += static_cast<std::uint64_t>(frequency);
+        if (word.size() > longestLength || longest.empty()) {
+            longestLength = word.size();
+            longest.clear();
+        }
+        if (word.size() == longestLength) longest.push_back(static_cast<std::uint32_t>(id));
+    }
+
+    size_t size() const { return frequencies.size(); }
+
+    void write(const std::string& path) const {
+        using namespace word_index_detail;
+        std::vector<std::uint32_t> byFrequency(frequencies.size());
+        std::iota(byFrequency.begin(), byFrequency.end(), 0u);
+        std::stable_sort(byFrequency.begin(), byFrequency.end(),
+            [this](std::uint32_t a, std::uint32_t b) { return frequencies[a] > frequencies[b]; });
+
+        Header header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.byteOrder = byteOrderTag;
+        header.blockSize = blockSize;
+        header.wordCount = frequencies.size();
+        header.totalCount = totalCount;
+        header.blockCount = blocks.size();
+        header.poolSize = pool.size();
+        header.longestCount = longest.size();
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) throw std::runtime_error("Could not open file: " + path);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeArray(file, blocks);
+        writeArray(file, frequencies);
+        writeArray(file, byFrequency);
+        writeArray(file, longest);
+        file.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+        if (!file) throw std::runtime_error("Could not write file: " + path);
+    }
+};
+
+#endif // WORD_INDEX_FILE_HPP
@@ -0,0 +1,317 @@
+#ifndef WORD_SKETCH_HPP
+#define WORD_SKETCH_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "word_data.hpp"
+#include "corpus_ingest.hpp"
+#include "mapped_file.hpp"
+#include "simd_tokenizer.hpp"
+
+
+namespace sketch_detail {
+
+    // FNV-1a with splitmix64's finalizer on top
+    inline std::uint64_t hash(std::string_view word) { return corpus_detail::mix(corpus_detail::hashWord(word)); }
+
+    inline unsigned countLeadingZeros(std::uint64_t value) { // value != 0
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return 63 - static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_clzll(value));
+#endif
+    }
+}
+
+// Number of distinct items in 2^precision bytes, whatever the length of the stream. Every item
+// is hashed; the first precision bits pick a register, which keeps the longest run of leading
+// zeros seen in the rest. The relative standard error is 1.04 / sqrt(2^precision), 0.8% at the
+// default 14. Two sketches of the same precision merge by taking the larger of each register,
+// which gives exactly the sketch of both streams together.
+class HyperLogLog {
+    std::vector<std::uint8_t> registers;
+    unsigned precision;
+
+public:
+    explicit HyperLogLog(unsigned precision = 14) : precision(precision) {
+        if (precision < 4 || precision > 18) throw std::invalid_argument("HyperLogLog precision must be in [4, 18]");
+        registers.assign(size_t(1) << precision, 0);
+    }
+
+    void add(std::uint64_t hash) {
+        size_t index = static_cast<size_t>(hash >> (64 - precision));
+        std::uint64_t rest = hash << precision | (std::uint64_t(1) << (precision - 1)); // Caps the run at 64 - precision
+        std::uint8_t rank = static_cast<std::uint8_t>(sketch_detail::countLeadingZeros(rest) + 1);
+        registers[index] = std::max(registers[index], rank);
+    }
+
+    void add(std::string_view item) { add(sketch_detail::hash(item)); }
+
+    double estimate() const {
+        const double m = static_cast<double>(registers.size());
+        double sum = 0;
+        size_t zeros = 0;
+        for (std::uint8_t r : registers) {
+            sum += std::ldexp(1.0, -r);
+            zeros += r == 0;
+        }
+        const double alpha = 0.7213 / (1 + 1.079 / m);
+        double raw = alpha * m * m / sum;
+        // Small cardinalities: linear counting over the empty registers is more accurate
+        if (raw <= 2.5 * m && zeros > 0) return m * std::log(m / static_cast<double>(zeros));
+        return raw;
+    }
+
+    double relativeError() const { return 1.04 / std::sqrt(static_cast<double>(registers.size())); }
+
+    void merge(const HyperLogLog& other) {
+        if (other.precision != precision) throw std::invalid_argument("Cannot merge HyperLogLog sketches of different precision");
+        for (size_t i = 0; i < registers.size(); ++i) registers[i] = std::max(registers[i], other.registers[i]);
+    }
+
+    size_t bytes() const { return registers.size(); }
+};
+
+// The most frequent items of a stream in capacity counters (Space-Saving). A new item that
+// finds the counters full takes over the one with the smallest count and inherits that count
+// as its possible overestimate, so every reported count is an upper bound, count - error a
+// lower bound, and an item more frequent than total / capacity is always kept.
+//
+// The counters form a min-heap on count, so an update is O(log capacity). Two summaries merge
+// by adding counts, charging an item missing from a full summary that summary's smallest count,
+// and keeping the capacity largest; the bounds still hold for the combined stream.
+class SpaceSaving {
+public:
+    struct Counter {
+        std::string item;
+        long long count = 0;
+        long long error = 0; // count - error <= true count <= count
+    };
+
+private:
+    std::vector<Counter> counters;               // Reserved to capacity up front: never moves
+    std::vector<size_t> heap;                    // Counter indices, smallest count first
+    std::vector<size_t> position;                // Place of each counter in heap
+    std::unordered_map<std::string_view, size_t> indexOf; // Views into counters[i].item
+    size_t capacity;
+    long long total = 0;
+
+    void swapNodes(size_t a, size_t b) {
+        std::swap(heap[a], heap[b]);
+        position[heap[a]] = a;
+        position[heap[b]] = b;
+    }
+
+    // Counts only grow, so a counter only moves down
+    void siftDown(size_t at) {
+        for (;;) {
+            size_t smallest = at, left = 2 * at + 1, right = left + 1;
+            if (left < heap.size() && counters[heap[left]].count < counters[heap[smallest]].count) smallest = left;
+            if (right < heap.size() && counters[heap[right]].count < counters[heap[smallest]].count) smallest = right;
+            if (smallest == at) return;
+            swapNodes(at, smallest);
+            at = smallest;
+        }
+    }
+
+    void rebuild() {
+        heap.resize(counters.size());
+        position.resize(counters.size());
+        indexOf.clear();
+        for (size_t i = 0; i < counters.size(); ++i) {
+            heap[i] = i;
+            indexOf.emplace(counters[i].item, i);
+        }
+        for (size_t i = heap.size() / 2; i-- > 0;) siftDown(i);
+        for (size_t i = 0; i < heap.size(); ++i) position[heap[i]] = i;
+    }
+
+    long long smallest() const { return counters.size() < capacity || heap.empty() ? 0 : counters[heap[0]].count; }
+
+public:
+    explicit SpaceSaving(size_t capacity = 1024) : capacity(std::max<size_t>(1, capacity)) {
+        counters.reserve(this->capacity);
+        indexOf.reserve(this->capacity);
+    }
+
+    SpaceSaving(const SpaceSaving& other) : counters(other.counters), capacity(other.capacity), total(other.total) {
+        counters.reserve(capacity);
+        rebuild();
+    }
+
+    SpaceSaving& operator=(const SpaceSaving& other) {
+        if (this != &other) {
+            counters = other.counters;
+            counters.reserve(other.capacity);
+            capacity = other.capacity;
+            total = other.total;
+            rebuild();
+        }
+        return *this;
+    }
+
+    void add(std::string_view item, long long count = 1) {
+        total += count;
+        auto it = indexOf.find(item);
+        if (it != indexOf.end()) {
+            counters[it->second].count += count;
+            siftDown(position[it->second]);
+            return;
+        }
+        if (counters.size() < capacity) {
+            size_t index = counters.size();
+            counters.push_back(Counter{ std::string(item), count, 0 });
+            indexOf.emplace(counters.back().item, index);
+            heap.push_back(index);
+            position.push_back(heap.size() - 1);
+            for (size_t at = heap.size() - 1; at > 0 && counters[heap[(at - 1) / 2]].count > counters[heap[at]].count; at = (at - 1) / 2)
+                swapNodes(at, (at - 1) / 2);
+            return;
+        }
+        // Take over the smallest counter
+        size_t index = heap[0];
+        Counter& counter = counters[index];
+        indexOf.erase(counter.item);
+        counter.item.assign(item);
+        counter.error = counter.count;
+        counter.count += count;
+        indexOf.emplace(counter.item, index);
+        siftDown(0);
+    }
+
+    void merge(const SpaceSaving& other) {
+        const long long ours = smallest(), theirs = other.smallest();
+        std::vector<Counter> combined;
+        combined.reserve(counters.size() + other.counters.size());
+        for (const Counter& counter : counters) {
+            auto it = other.indexOf.find(counter.item);
+            if (it == other.indexOf.end()) combined.push_back(Counter{ counter.item, counter.count + theirs, counter.error + theirs });
+            else {
+                const Counter& match = other.counters[it->second];
+                combined.push_back(Counter{ counter.item, counter.count + match.count, counter.error + match.error });
+            }
+        }
+        for (const Counter& counter : other.counters)
+            if (!indexOf.count(counter.item)) combined.push_back(Counter{ counter.item, counter.count + ours, counter.error + ours });
+        if (combined.size() > capacity) {
+            std::nth_element(combined.begin(), combined.begin() + static_cast<std::ptrdiff_t>(capacity) - 1, combined.end(),
+                [](const Counter& a, const Counter& b) { return a.count > b.count; });
+            combined.resize(capacity);
+        }
+        counters = std::move(combined);
+        counters.reserve(capacity);
+        total += other.total;
+        rebuild();
+    }
+
+    // The k largest counters, largest first
+    std::vector<Counter> top(size_t k) const {
+        std::vector<Counter> result(counters);
+        k = std::min(k, result.size());
+        std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(k), result.end(),
+            [](const Counter& a, const Counter& b) { return a.count != b.count ? a.count > b.count : a.item < b.item; });
+        result.resize(k);
+        return result;
+    }
+
+    // Upper bound on the count of item: its counter, or the smallest count if it has none
+    long long upperBound(std::string_view item) const {
+        auto it = indexOf.find(item);
+        return it != indexOf.end() ? counters[it->second].count : smallest();
+    }
+
+    // The most any counter can be off by: total / capacity
+    long long maxError() const { return total / static_cast<long long>(capacity); }
+    long long totalCount() const { return total; }
+};
+
+// Approximate WordData statistics in fixed memory, for streams too long to keep every word:
+//
+//     WordSketch sketch = sketchCorpus("data/corpus.txt");
+//     std::cout << sketch.getUniqueWordCount() << " +- " << sketch.uniqueWordCountError() * 100 << "%";
+//     for (const auto& word : sketch.top_k(10)) ...
+//
+// Words are normalized like WordData's. The unique count comes from a HyperLogLog, the most
+// frequent words from Space-Saving, and the total is exact. Sketches from different threads or
+// files merge into the sketch of everything they have seen, as long as they were made with the
+// same parameters.
+class WordSketch {
+    HyperLogLog distinct;
+    SpaceSaving heavy;
+    long long totalWords = 0;
+
+public:
+    explicit WordSketch(size_t heavyHitters = 1024, unsigned precision = 14) : distinct(precision), heavy(heavyHitters) {}
+
+    void insert(const Word& word) {
+        std::string key = WordData::normalize(word.word);
+        if (key.empty()) return;
+        insertNormalized(key, word.frequency);
+    }
+
+    // For words that are already normalized, e.g. the Tokenizer's
+    void insertNormalized(std::string_view word, int count = 1) {
+        distinct.add(word);
+        heavy.add(word, count);
+        totalWords += count;
+    }
+
+    // Tokenizes text like WordData(path); returns the number of words
+    size_t insertText(std::string_view text) {
+        thread_local Tokenizer tokenizer;
+        return tokenizer.forEachWord(text, [this](std::string_view word) { insertNormalized(word); });
+    }
+
+    void merge(const WordSketch& other) {
+        distinct.merge(other.distinct);
+        heavy.merge(other.heavy);
+        totalWords += other.totalWords;
+    }
+
+    long long getTotalWordCount() const { return totalWords; }
+    long long getUniqueWordCount() const { return std::llround(distinct.estimate()); }
+    double uniqueWordCountError() const { return distinct.relativeError(); } // Relative standard error
+
+    std::vector<std::string> top_k(int k) const {
+        std::vector<std::string> result;
+        for (const auto& counter : heavy.top(static_cast<size_t>(std::max(k, 0)))) result.push_back(counter.item);
+        return result;
+    }
+
+    // The k heaviest words with their counts and how much each count may be too high
+    std::vector<SpaceSaving::Counter> heavyHitters(size_t k) const { return heavy.top(k); }
+
+    long long frequencyUpperBound(const std::string& word) const { return heavy.upperBound(WordData::normalize(word)); }
+    long long maxFrequencyError() const { return heavy.maxError(); }
+};
+
+// Sketches the corpus at path with the chunks and tokenizer of countCorpus, one WordSketch
+// per thread, merged at the end
+inline WordSketch sketchCorpus(const std::string& path, unsigned threads = std::max(1u, std::thread::hardware_concurrency()),
+    size_t heavyHitters = 1024, unsigned precision = 14) {
+    MappedFile file(path, true);
+    const char* data = file.data();
+    const std::vector<size_t> bounds = corpus_detail::splitChunks(data, file.size(), threads);
+    std::vector<WordSketch> sketches(bounds.size() - 1, WordSketch(heavyHitters, precision));
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t + 1 < bounds.size(); ++t) {
+        pool.emplace_back([&, t]() {
+            corpus_detail::forEachPiece(data, bounds[t], bounds[t + 1], [&](std::string_view piece) { sketches[t].insertText(piece); });
+            });
+    }
+    for (auto& thread : pool) thread.join();
+    for (size_t t = 1; t < sketches.size(); ++t) sketches[0].merge(sketches[t]);
+    return std::move(sketches[0]);
+}
+
+#endif // WORD_SKETCH_HPP